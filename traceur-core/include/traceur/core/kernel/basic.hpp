@@ -24,13 +24,213 @@
 #ifndef TRACEUR_CORE_KERNEL_BASIC_H
 #define TRACEUR_CORE_KERNEL_BASIC_H
 
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#include <traceur/core/kernel/curve.hpp>
+#include <traceur/core/kernel/hit.hpp>
 #include <traceur/core/kernel/kernel.hpp>
 #include <traceur/core/kernel/pixel.hpp>
+#include <traceur/core/kernel/ray.hpp>
+#include <traceur/core/kernel/statistics.hpp>
+#include <traceur/core/lightning/cache.hpp>
+#include <traceur/core/lightning/photon.hpp>
+#include <traceur/core/lightning/tree.hpp>
+#include <traceur/core/material/material.hpp>
+#include <traceur/core/math/isa.hpp>
+#include <traceur/core/sampler/sampler.hpp>
+#include <traceur/core/scene/primitive/primitive.hpp>
 
 namespace traceur {
 
     const float globalOffset = 0.00001f;
 
+	/**
+	 * The distance in front of a hit an occluder must lie in order to be
+	 * classified as shadow. This is larger than the diagonal of the epsilon
+	 * cube used to compare shadow hits with the shaded point.
+	 */
+	const float occluderEpsilon = 0.002f;
+
+	/**
+	 * The half extent of the cube around a light in which the light is
+	 * sampled to obtain soft shadows.
+	 */
+	const float lightRadius = 0.05f;
+
+	/**
+	 * The settings of the adaptive anti-aliasing of the kernel.
+	 *
+	 * Each pixel initially receives {@link AntiAliasing::minSamples} jittered
+	 * samples. Pixels are refined up to {@link AntiAliasing::maxSamples}
+	 * samples while the standard error of their mean luminance exceeds
+	 * {@link AntiAliasing::threshold}, or when they differ noticeably from
+	 * an adjacent pixel that has already been rendered (which usually
+	 * indicates an edge).
+	 *
+	 * Only the neighbours within the same partition of the film are compared,
+	 * since the partitions are rendered by independent jobs. Edges that
+	 * coincide with the border of a partition are therefore only refined by
+	 * the standard error of their pixels.
+	 */
+	struct AntiAliasing {
+		/**
+		 * The amount of samples each pixel receives.
+		 */
+		int minSamples;
+
+		/**
+		 * The maximum amount of samples of a pixel. Anti-aliasing is disabled
+		 * when this is at most one, in which case a single ray is traced
+		 * through the corner of each pixel.
+		 */
+		int maxSamples;
+
+		/**
+		 * The standard error of the mean luminance of a pixel above which
+		 * the pixel is refined.
+		 */
+		float threshold;
+
+		/**
+		 * The relative luminance difference with a neighbouring pixel above
+		 * which a pixel is refined.
+		 */
+		float contrast;
+
+		/**
+		 * Construct an {@link AntiAliasing} instance with anti-aliasing
+		 * disabled.
+		 */
+		AntiAliasing() : minSamples(1), maxSamples(1), threshold(0.01f), contrast(0.1f) {}
+
+		/**
+		 * Construct an {@link AntiAliasing} instance.
+		 *
+		 * @param[in] minSamples The initial amount of samples per pixel.
+		 * @param[in] maxSamples The maximum amount of samples per pixel.
+		 * @param[in] threshold The standard error threshold.
+		 * @param[in] contrast The neighbour contrast threshold.
+		 */
+		AntiAliasing(int minSamples, int maxSamples, float threshold, float contrast = 0.1f) :
+			minSamples(minSamples), maxSamples(maxSamples), threshold(threshold), contrast(contrast) {}
+
+		/**
+		 * Determine whether anti-aliasing is enabled.
+		 *
+		 * @return <code>true</code> if pixels are supersampled,
+		 * <code>false</code> otherwise.
+		 */
+		inline bool enabled() const
+		{
+			return maxSamples > 1;
+		}
+	};
+
+	/* Forward declarations */
+	class BasicKernel;
+	struct TracingContext;
+
+	/**
+	 * This struct represents the mutable state of a render job of the kernel.
+	 * A render job is executed by a single thread, so this state is never
+	 * shared between threads.
+	 */
+	struct RenderState {
+		/**
+		 * The primitive that occluded the last shadow ray towards each light
+		 * in the scene, or <code>nullptr</code> if there is none.
+		 */
+		std::vector<const traceur::Primitive *> occluders;
+
+		/**
+		 * The statistics collected during the render job.
+		 */
+		traceur::KernelStatistics statistics;
+
+		/**
+		 * The stream of sample dimensions of the pixel that is being
+		 * rendered.
+		 */
+		traceur::SampleStream samples;
+
+		/**
+		 * The hierarchy over the lights of the scene, which is shared by the
+		 * render jobs of the scene, or <code>nullptr</code> if all lights
+		 * are evaluated at every shading point.
+		 */
+		std::shared_ptr<const traceur::LightTree> lights;
+
+		/**
+		 * The pixels of the film that have been rendered during the render
+		 * job, which the adaptive anti-aliasing compares new pixels with.
+		 */
+		std::vector<bool> rendered;
+
+		/**
+		 * The photon map of the caustics of the scene, which is added to the
+		 * diffuse illumination, or <code>nullptr</code> if there is none.
+		 */
+		const traceur::PhotonMap *caustics;
+
+		/**
+		 * The attributes of the first hit of the primary rays of the pixel
+		 * that is being rendered are gathered into this pixel, or
+		 * <code>nullptr</code> if the film holds no channels of them.
+		 */
+		traceur::AuxiliaryPixel *auxiliary;
+
+		/**
+		 * The function that traces a ray into the scene, which is specialized
+		 * for the type of the graph of the scene and compiled for the active
+		 * instruction set.
+		 */
+		traceur::Pixel (traceur::BasicKernel::*trace)(const traceur::Scene &,
+													  const traceur::Camera &,
+													  const traceur::Ray &,
+													  int,
+													  traceur::RenderState &) const;
+
+		/**
+		 * The function that calculates the visible fraction of a light, which
+		 * is specialized for the type of the graph of the scene and compiled
+		 * for the active instruction set.
+		 */
+		float (traceur::BasicKernel::*lightLevel)(const traceur::TracingContext &, size_t) const;
+
+		/**
+		 * Construct a {@link RenderState} instance.
+		 *
+		 * @param[in] lights The amount of lights in the scene.
+		 * @param[in] sampler The sampler to draw samples from.
+		 */
+		RenderState(size_t lights, const traceur::Sampler &sampler) :
+			occluders(lights, nullptr), samples(sampler), caustics(nullptr), auxiliary(nullptr),
+			trace(nullptr), lightLevel(nullptr) {}
+
+		/**
+		 * Record the attributes of the first hit of a primary ray if the
+		 * render job writes them into the channels of the film.
+		 *
+		 * @param[in] albedo The diffuse color of the surface that was hit.
+		 * @param[in] ray The primary ray.
+		 * @param[in] hit The first hit of the ray.
+		 */
+		inline void record(const glm::vec3 &albedo, const traceur::Ray &ray, const traceur::Hit &hit)
+		{
+			if (auxiliary) {
+				auxiliary->albedo += albedo;
+				auxiliary->normal += glm::dot(hit.normal, ray.direction) <= 0 ? hit.normal : -hit.normal;
+				auxiliary->depth += hit.distance;
+				if (auxiliary->primitive == std::numeric_limits<uint32_t>::max()) {
+					auxiliary->primitive = hit.primitive->id;
+					auxiliary->material = hit.primitive->material;
+				}
+			}
+		}
+	};
+
 	/**
 	 * This struct represents the ray-tracing context of the kernel.
 	 */
@@ -55,6 +255,11 @@ namespace traceur {
 		 */
 		const traceur::Hit &hit;
 
+		/**
+		 * The state of the render job this context belongs to.
+		 */
+		traceur::RenderState &state;
+
 		/**
 		 * Construct a {@link TracingContext}
 		 *
@@ -62,35 +267,218 @@ namespace traceur {
 		 * @param[in] camera The camera of this context.
 		 * @param[in] ray The ray that is being traced into the scene.
 		 * @param[in] hit The hit that occured.
+		 * @param[in] state The state of the render job.
 		 */
 		TracingContext(const traceur::Scene &scene,
 					   const traceur::Camera &camera,
 					   const traceur::Ray &ray,
-					   const traceur::Hit &hit) : scene(scene), camera(camera), ray(ray), hit(hit) {}
+					   const traceur::Hit &hit,
+					   traceur::RenderState &state) : scene(scene), camera(camera), ray(ray), hit(hit), state(state) {}
+	};
+
+	/**
+	 * The amount of illumination models of the MTL specification.
+	 */
+	const int IlluminationModels = 10;
+
+	/**
+	 * The shading features of an illumination model of the MTL
+	 * specification, which are used to specialize the shading of the
+	 * {@link BasicKernel} for each model at compile time.
+	 *
+	 * Models 5 and 7 should use Fresnel reflection and refraction, but
+	 * currently fall back to normal reflection and refraction.
+	 *
+	 * @tparam Model The illumination model.
+	 */
+	template<int Model>
+	struct IlluminationModel {
+		/**
+		 * Whether the model is lit by the lights in the scene, or outputs the
+		 * diffuse color directly otherwise.
+		 */
+		static constexpr bool lit = Model > 0 && Model < IlluminationModels;
+
+		/**
+		 * Whether the model has a specular highlight of the lights.
+		 */
+		static constexpr bool specular = Model == 2 || Model == 3 || Model == 4 || Model == 6
+										 || Model == 8 || Model == 9;
+
+		/**
+		 * Whether the model reflects the scene.
+		 */
+		static constexpr bool reflection = Model >= 3 && Model < IlluminationModels;
+
+		/**
+		 * Whether the model is transparent without refraction.
+		 */
+		static constexpr bool transparency = Model == 4;
+
+		/**
+		 * Whether the model refracts the scene.
+		 */
+		static constexpr bool refraction = Model == 6 || Model == 7;
 	};
 
+	/**
+	 * Determine the features a {@link BasicKernel} must be specialized for in
+	 * order to render the given scene.
+	 *
+	 * @param[in] scene The scene to render.
+	 * @param[in] sampledLights The amount of lights above which lights are
+	 * sampled.
+	 * @return The mask of {@link SceneFeatures::Feature} values.
+	 */
+	inline unsigned kernel_features(const traceur::Scene &scene, int sampledLights = 4)
+	{
+		unsigned features = scene.features.mask();
+		if (sampledLights > 0 && scene.lights.size() > static_cast<size_t>(sampledLights)) {
+			features |= traceur::SceneFeatures::LightSampling;
+		}
+		return features;
+	}
+
 	/**
 	 * A basic CPU raytracing {@link Kernel}.
 	 */
 	class BasicKernel: public Kernel {
 	public:
+		/**
+		 * The sampler that generates the sample points of the kernel.
+		 */
+		std::shared_ptr<traceur::Sampler> sampler;
+
+		/**
+		 * The amount of shadow rays that are cast towards each light.
+		 */
+		int lightSamples;
+
+		/**
+		 * The amount of lights that are importance sampled per shading point
+		 * from a {@link LightTree} if the scene contains more lights than
+		 * this. Otherwise, or if this is zero, all lights are evaluated.
+		 */
+		int sampledLights;
+
+		/**
+		 * The adaptive anti-aliasing settings of the kernel.
+		 */
+		traceur::AntiAliasing antiAliasing;
+
+		/**
+		 * The order in which the pixels of a partition are rendered.
+		 */
+		traceur::SpaceFillingCurve pixelOrder;
+
+		/**
+		 * The cache of the visibility of the lights, which is shared between
+		 * renders of the same static scene, or <code>nullptr</code> to trace
+		 * the shadow rays of every shading point.
+		 */
+		std::shared_ptr<traceur::VisibilityCache> visibilityCache;
+
+		/**
+		 * The mask of {@link Channels::Channel} values the kernel writes
+		 * into the film besides the color of the pixels. Only the planes of
+		 * these channels are allocated, so a kernel that renders only the
+		 * color does not pay for the other channels.
+		 */
+		unsigned channels;
+
+		/**
+		 * Construct a {@link BasicKernel} instance which samples the lights
+		 * with an Owen-scrambled Sobol sequence and supports all scenes.
+		 */
+		BasicKernel();
+
+		/**
+		 * Construct a {@link BasicKernel} instance.
+		 *
+		 * @param[in] sampler The sampler to use.
+		 * @param[in] lightSamples The amount of shadow rays per light.
+		 * @param[in] features The mask of {@link SceneFeatures::Feature}
+		 * values the kernel is specialized for. Scenes that use other
+		 * features are rendered without them.
+		 */
+		BasicKernel(std::shared_ptr<traceur::Sampler>, int, unsigned = traceur::SceneFeatures::All);
+
 		/**
 		 * Trace a single ray into the {@link Scene}.
 		 *
+		 * @tparam Graph The type of the graph of the scene.
 		 * @param[in] scene The scene to trace the ray into.
 		 * @param[in] camera The camera that captures the scene.
 		 * @param[in] ray The ray that is traced.
 		 * @param[in] depth The depth of the recursion.
+		 * @param[in] state The state of the render job.
 		 * @return The color that has been found by the kernel.
 		 */
+		template<class Graph>
 		traceur::Pixel trace(const traceur::Scene &,
 							 const traceur::Camera &,
 							 const traceur::Ray &,
-							 int) const;
+							 int,
+							 traceur::RenderState &) const;
 
-		float lightLevel(const traceur::Light & lightSource, const traceur::Hit & hit, const traceur::Scene & scene) const;
+		/**
+		 * Adaptively supersample a single pixel of the film.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @param[in] scene The scene to render.
+		 * @param[in] camera The camera that captures the scene.
+		 * @param[in] rays The generator of the primary rays of the camera.
+		 * @param[in] film The film that is rendered into, of which the already
+		 * rendered neighbours of the pixel are inspected.
+		 * @param[in] pos The position of the pixel within the film.
+		 * @param[in] offset The offset of the film on the screen.
+		 * @param[in] first The index of the first sample of the pixel.
+		 * @param[in] state The state of the render job.
+		 * @param[out] count The amount of samples that have been taken.
+		 * @return The mean color of the samples.
+		 */
+		template<class Graph>
+		traceur::Pixel supersample(const traceur::Scene &,
+								   const traceur::Camera &,
+								   const traceur::RayGenerator &,
+								   const traceur::Film &,
+								   const glm::ivec2 &,
+								   const glm::ivec2 &,
+								   uint32_t,
+								   traceur::RenderState &,
+								   int &) const;
 
-		float localLightLevel(const traceur::Light & lightSource, const traceur::Hit & hit, const traceur::Scene & scene) const;
+		/**
+		 * Calculate the fraction of an (area) light that is visible from the
+		 * hit in the given context.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @param[in] context The context within we are shading.
+		 * @param[in] light The index of the light in the scene.
+		 * @return The visible fraction of the light.
+		 */
+		template<class Graph>
+		float lightLevel(const traceur::TracingContext &, size_t) const;
+
+		/**
+		 * Determine whether the given point on a light is visible from the hit
+		 * in the given context.
+		 *
+		 * The primitive that occluded the previous shadow ray towards the same
+		 * light is tested first, since neighbouring points are usually
+		 * shadowed by the same primitive.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @param[in] context The context within we are shading.
+		 * @param[in] lightSource The point on the light to test.
+		 * @param[in] light The index of the light in the scene.
+		 * @return <code>1</code> if the point is visible, <code>0</code>
+		 * otherwise.
+		 */
+		template<class Graph>
+		float localLightLevel(const traceur::TracingContext &,
+							  const glm::vec3 &,
+							  size_t) const;
 
 		/**
 		 * Shade a pixel with a given {@link Hit}.
@@ -101,6 +489,22 @@ namespace traceur {
 		 */
 		traceur::Pixel shade(const traceur::TracingContext &, int) const;
 
+		/**
+		 * Shade a pixel with a given {@link Hit} on a material of the given
+		 * illumination model.
+		 *
+		 * @tparam Model The illumination model of the material.
+		 * @tparam Features The scene features the kernel is specialized for.
+		 * @param[in] context The context within we are shading.
+		 * @param[in] material The material of the primitive that was hit.
+		 * @param[in] depth The depth of the recursion.
+		 * @return The color that has been found.
+		 */
+		template<int Model, unsigned Features>
+		traceur::Pixel shadeModel(const traceur::TracingContext &,
+								  const traceur::Material &,
+								  int) const;
+
 		/**
 		 * Calculate the diffuse effect for the given hit, given the direction
 		 * of a light.
@@ -186,16 +590,208 @@ namespace traceur {
 							traceur::Film &,
 							const glm::ivec2 &) const final;
 
+		/**
+		 * Render a single pass of a progressive render job of the given
+		 * {@link Scene} into a {@link Film}.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] pass The index of the pass to render.
+		 * @return A {@link Film} of the scene to take ownership over.
+		 */
+		virtual std::unique_ptr<traceur::Film> render(const traceur::Scene &,
+													  const traceur::Camera &,
+													  int) const final;
+
+		/**
+		 * Render a single pass of a progressive render job of a part of the
+		 * given {@link Scene} into the {@link Film} passed to this function.
+		 *
+		 * The first pass equals the regular render job. Subsequent passes
+		 * jitter the primary rays within the pixels and use the following
+		 * sample indices of the sampler.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] film The film to render the scene into.
+		 * @param[in] offset The offset of the screen.
+		 * @param[in] pass The index of the pass to render.
+		 */
+		virtual void render(const traceur::Scene &,
+							const traceur::Camera &,
+							traceur::Film &,
+							const glm::ivec2 &,
+							int) const final;
+
 		/**
 		 * Return the name of this kernel.
 		 *
 		 * @return A string representing the name of this kernel.
 		 */
-		virtual const std::string & name() const final
+		virtual const std::string & name() const
 		{
 			static const std::string name = "basic";
 			return name;
 		}
+
+		/**
+		 * Return a snapshot of the statistics this kernel has collected over
+		 * all render jobs so far.
+		 *
+		 * @return The statistics of this kernel.
+		 */
+		virtual traceur::KernelStatistics statistics() const final;
+
+		/**
+		 * Return the mask of scene features the kernel is specialized for.
+		 *
+		 * @return The mask of {@link SceneFeatures::Feature} values.
+		 */
+		inline unsigned features() const
+		{
+			return m_features;
+		}
+	protected:
+		/**
+		 * Prepare the state of a render job before the job renders the
+		 * given {@link Scene}. This is called by every render job, possibly
+		 * from several threads at once.
+		 *
+		 * @param[in] scene The {@link Scene} that is going to be rendered.
+		 * @param[in] state The state of the render job.
+		 */
+		virtual void prepare(const traceur::Scene &, traceur::RenderState &) const {}
+	private:
+		/**
+		 * A pointer to a shading function of a specific illumination model.
+		 */
+		using Shader = traceur::Pixel (traceur::BasicKernel::*)(const traceur::TracingContext &,
+																 const traceur::Material &,
+																 int) const;
+
+		/**
+		 * Return the table of shading functions indexed by illumination model
+		 * that is specialized for the given features.
+		 *
+		 * @tparam Features The scene features to specialize for.
+		 * @return The table of shading functions.
+		 */
+		template<unsigned Features>
+		static const Shader * shaders();
+
+		/**
+		 * Trace a single ray into the {@link Scene} with the tracer compiled
+		 * for the given instruction set.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @tparam I The instruction set to compile the tracer for.
+		 * @param[in] scene The scene to trace the ray into.
+		 * @param[in] camera The camera that captures the scene.
+		 * @param[in] ray The ray that is traced.
+		 * @param[in] depth The depth of the recursion.
+		 * @param[in] state The state of the render job.
+		 * @return The color that has been found by the kernel.
+		 */
+		template<class Graph, traceur::ISA I>
+		traceur::Pixel traceVariant(const traceur::Scene &,
+									const traceur::Camera &,
+									const traceur::Ray &,
+									int,
+									traceur::RenderState &) const;
+
+		/**
+		 * Calculate the visible fraction of a light with the shadow rays
+		 * compiled for the given instruction set.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @tparam I The instruction set to compile the shadow rays for.
+		 * @param[in] context The context within we are shading.
+		 * @param[in] light The index of the light in the scene.
+		 * @return The visible fraction of the light.
+		 */
+		template<class Graph, traceur::ISA I>
+		float lightLevelVariant(const traceur::TracingContext &, size_t) const;
+
+		/**
+		 * Bind the tracer and the shadow rays for the given type of graph
+		 * and the active instruction set to the state of a render job.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @param[in] state The state of the render job.
+		 */
+		template<class Graph>
+		void bind(traceur::RenderState &) const;
+
+		/**
+		 * Render a part of the given {@link Scene} into the {@link Film}
+		 * passed to this function, of which the graph has the given type.
+		 *
+		 * The graph is intersected through its concrete type, so that its
+		 * traversal is inlined into the tracer, which is compiled for each
+		 * instruction set and selected once for the job.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] film The film to render the scene into.
+		 * @param[in] offset The offset of the screen.
+		 * @param[in] pass The index of the pass to render.
+		 */
+		template<class Graph>
+		void renderGraph(const traceur::Scene &,
+						 const traceur::Camera &,
+						 traceur::Film &,
+						 const glm::ivec2 &,
+						 int) const;
+
+		/**
+		 * Return the {@link LightTree} of the given {@link Scene}, which is
+		 * built once per scene and shared read-only by its render jobs.
+		 *
+		 * @param[in] scene The scene to return the light tree of.
+		 * @return The light tree of the scene.
+		 */
+		std::shared_ptr<const traceur::LightTree> lightTree(const traceur::Scene &) const;
+
+		/**
+		 * The mask of scene features the kernel is specialized for.
+		 */
+		unsigned m_features;
+
+		/**
+		 * The shading functions of the kernel indexed by illumination model.
+		 */
+		const Shader *m_shaders;
+
+		/**
+		 * The statistics of the finished render jobs.
+		 */
+		mutable traceur::KernelStatistics m_statistics;
+
+		/**
+		 * The lock protecting the statistics of the kernel.
+		 */
+		mutable std::mutex mutex;
+
+		/**
+		 * The light tree of the scene that has been rendered last.
+		 */
+		mutable std::shared_ptr<const traceur::LightTree> m_lightTree;
+
+		/**
+		 * The generation of the scene the light tree was built for.
+		 */
+		mutable uint64_t m_lightGeneration;
+
+		/**
+		 * The lights the light tree was built from.
+		 */
+		mutable std::vector<traceur::Light> m_treeLights;
+
+		/**
+		 * The lock protecting the light tree of the kernel.
+		 */
+		mutable std::mutex m_lightMutex;
 	};
 }
 
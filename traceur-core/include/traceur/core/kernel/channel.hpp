@@ -0,0 +1,301 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_CHANNEL_H
+#define TRACEUR_CORE_KERNEL_CHANNEL_H
+
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace traceur {
+	/**
+	 * The channels a {@link Film} can hold besides the color of its pixels.
+	 */
+	struct Channels {
+		/**
+		 * The planes of a film, of which a kernel may write any subset.
+		 */
+		enum Channel : unsigned {
+			/**
+			 * The distance from the camera to the surface seen through a
+			 * pixel, or zero if the pixel sees no surface.
+			 */
+			Depth = 1 << 0,
+
+			/**
+			 * The normal of the surface seen through a pixel, facing the
+			 * camera.
+			 */
+			Normal = 1 << 1,
+
+			/**
+			 * The diffuse color of the surface seen through a pixel.
+			 */
+			Albedo = 1 << 2,
+
+			/**
+			 * The identifier of the primitive seen through a pixel.
+			 */
+			PrimitiveId = 1 << 3,
+
+			/**
+			 * The index of the material of the surface seen through a pixel.
+			 */
+			MaterialId = 1 << 4,
+
+			/**
+			 * The amount of samples taken for a pixel.
+			 */
+			SampleCount = 1 << 5,
+
+			/**
+			 * The channels that guide the {@link Denoiser}.
+			 */
+			Auxiliary = Depth | Normal | Albedo,
+
+			/**
+			 * All channels a film can hold.
+			 */
+			All = (1 << 6) - 1
+		};
+	};
+
+	/**
+	 * Convert a single-precision floating point number to half precision.
+	 * Numbers too small for a normalized half are flushed to zero, numbers
+	 * too large become infinite and NaNs stay NaNs.
+	 *
+	 * @param[in] value The value to convert.
+	 * @return The bits of the half-precision value.
+	 */
+	inline uint16_t pack_half(float value)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &value, sizeof(bits));
+		uint32_t sign = (bits >> 16) & 0x8000u;
+		int exponent = static_cast<int>((bits >> 23) & 0xffu) - 127 + 15;
+		uint32_t mantissa = bits & 0x7fffffu;
+
+		if (exponent == 255 - 127 + 15 && mantissa != 0) {
+			// keep the upper bits of the payload and set the quiet bit, so
+			// the mantissa of the half cannot become zero
+			return static_cast<uint16_t>(sign | 0x7e00u | (mantissa >> 13));
+		} else if (exponent <= 0) {
+			return static_cast<uint16_t>(sign);
+		} else if (exponent >= 31) {
+			return static_cast<uint16_t>(sign | 0x7c00u);
+		}
+
+		// round to the nearest half, which may carry into the exponent
+		uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+		return static_cast<uint16_t>(half + ((mantissa >> 12) & 1u));
+	}
+
+	/**
+	 * Convert a half-precision floating point number to single precision.
+	 *
+	 * @param[in] half The bits of the half-precision value.
+	 * @return The value as single-precision floating point number.
+	 */
+	inline float unpack_half(uint16_t half)
+	{
+		uint32_t sign = static_cast<uint32_t>(half & 0x8000u) << 16;
+		uint32_t exponent = (half >> 10) & 0x1fu;
+		uint32_t mantissa = half & 0x3ffu;
+		uint32_t bits = sign;
+
+		if (exponent == 31) {
+			bits |= 0x7f800000u | (mantissa << 13);
+		} else if (exponent > 0) {
+			bits |= ((exponent - 15 + 127) << 23) | (mantissa << 13);
+		}
+
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	/**
+	 * A normal stored with half-precision components.
+	 */
+	struct HalfNormal {
+		/**
+		 * The components of the normal.
+		 */
+		uint16_t x, y, z;
+
+		/**
+		 * Construct a zero {@link HalfNormal} instance.
+		 */
+		HalfNormal() : x(0), y(0), z(0) {}
+
+		/**
+		 * Construct a {@link HalfNormal} instance.
+		 *
+		 * @param[in] normal The normal to store.
+		 */
+		HalfNormal(const glm::vec3 &normal) :
+			x(traceur::pack_half(normal.x)), y(traceur::pack_half(normal.y)), z(traceur::pack_half(normal.z)) {}
+
+		/**
+		 * Return the normal as single-precision vector.
+		 *
+		 * @return The normal.
+		 */
+		operator glm::vec3() const
+		{
+			return glm::vec3(traceur::unpack_half(x), traceur::unpack_half(y), traceur::unpack_half(z));
+		}
+	};
+
+	/**
+	 * The type of the values and the position of the plane of a channel
+	 * within {@link ChannelPlanes}.
+	 *
+	 * @tparam C The channel.
+	 */
+	template<traceur::Channels::Channel C>
+	struct ChannelTraits;
+
+	template<>
+	struct ChannelTraits<traceur::Channels::Depth> {
+		using type = float;
+		static const size_t index = 0;
+		static type empty() { return 0.f; }
+	};
+
+	template<>
+	struct ChannelTraits<traceur::Channels::Normal> {
+		using type = traceur::HalfNormal;
+		static const size_t index = 1;
+		static type empty() { return traceur::HalfNormal(); }
+	};
+
+	template<>
+	struct ChannelTraits<traceur::Channels::Albedo> {
+		using type = glm::vec3;
+		static const size_t index = 2;
+		static type empty() { return glm::vec3(0.f); }
+	};
+
+	template<>
+	struct ChannelTraits<traceur::Channels::PrimitiveId> {
+		using type = uint32_t;
+		static const size_t index = 3;
+		static type empty() { return std::numeric_limits<uint32_t>::max(); }
+	};
+
+	template<>
+	struct ChannelTraits<traceur::Channels::MaterialId> {
+		using type = uint32_t;
+		static const size_t index = 4;
+		static type empty() { return std::numeric_limits<uint32_t>::max(); }
+	};
+
+	template<>
+	struct ChannelTraits<traceur::Channels::SampleCount> {
+		using type = uint16_t;
+		static const size_t index = 5;
+		static type empty() { return 0; }
+	};
+
+	/**
+	 * The planes of the channels of a film, which are only allocated for the
+	 * channels the film holds.
+	 */
+	using ChannelPlanes = std::tuple<
+		std::vector<traceur::ChannelTraits<traceur::Channels::Depth>::type>,
+		std::vector<traceur::ChannelTraits<traceur::Channels::Normal>::type>,
+		std::vector<traceur::ChannelTraits<traceur::Channels::Albedo>::type>,
+		std::vector<traceur::ChannelTraits<traceur::Channels::PrimitiveId>::type>,
+		std::vector<traceur::ChannelTraits<traceur::Channels::MaterialId>::type>,
+		std::vector<traceur::ChannelTraits<traceur::Channels::SampleCount>::type>
+	>;
+
+	/**
+	 * A tag type that identifies a channel at compile time.
+	 *
+	 * @tparam C The channel.
+	 */
+	template<traceur::Channels::Channel C>
+	using ChannelTag = std::integral_constant<traceur::Channels::Channel, C>;
+
+	/**
+	 * Invoke the given function object with the {@link ChannelTag} of a
+	 * channel that is only known at runtime, so the function object can be
+	 * instantiated for the type of the values of each channel.
+	 *
+	 * @param[in] channel The channel to pass the tag of.
+	 * @param[in] function The generic function object to invoke.
+	 * @return The result of the function object, or a value-initialized
+	 * result if the channel is not a single known channel.
+	 */
+	template<class Function>
+	inline auto visit_channel(traceur::Channels::Channel channel, Function &&function)
+		-> decltype(function(traceur::ChannelTag<traceur::Channels::Depth>()))
+	{
+		switch (channel) {
+			case traceur::Channels::Depth:
+				return function(traceur::ChannelTag<traceur::Channels::Depth>());
+			case traceur::Channels::Normal:
+				return function(traceur::ChannelTag<traceur::Channels::Normal>());
+			case traceur::Channels::Albedo:
+				return function(traceur::ChannelTag<traceur::Channels::Albedo>());
+			case traceur::Channels::PrimitiveId:
+				return function(traceur::ChannelTag<traceur::Channels::PrimitiveId>());
+			case traceur::Channels::MaterialId:
+				return function(traceur::ChannelTag<traceur::Channels::MaterialId>());
+			case traceur::Channels::SampleCount:
+				return function(traceur::ChannelTag<traceur::Channels::SampleCount>());
+			default:
+				return decltype(function(traceur::ChannelTag<traceur::Channels::Depth>()))();
+		}
+	}
+
+	/**
+	 * Return the name of a channel.
+	 *
+	 * @param[in] channel The channel to return the name of.
+	 * @return The name of the channel.
+	 */
+	const char * channel_name(traceur::Channels::Channel);
+
+	/**
+	 * Parse a comma-separated list of channel names.
+	 *
+	 * @param[in] names The names of the channels.
+	 * @param[out] channels The mask of the parsed channels.
+	 * @return <code>true</code> if all names are known, otherwise
+	 * <code>false</code>.
+	 */
+	bool parse_channels(const std::string &, unsigned &);
+}
+
+#endif /* TRACEUR_CORE_KERNEL_CHANNEL_H */
@@ -0,0 +1,90 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_CURVE_H
+#define TRACEUR_CORE_KERNEL_CURVE_H
+
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace traceur {
+	/**
+	 * An order in which the cells of a grid are visited, such as the pixels
+	 * of a partition or the partitions of a film. The space-filling curves
+	 * visit cells that are close in the grid consecutively, so consecutive
+	 * rays tend to touch the same nodes of the scene graph.
+	 */
+	enum class SpaceFillingCurve: int {
+		/**
+		 * Row by row, from left to right.
+		 */
+		Scanline = 0,
+
+		/**
+		 * The Z-order curve, which interleaves the bits of the coordinates.
+		 * A cell is always visited after its left and upper neighbour.
+		 */
+		Morton = 1,
+
+		/**
+		 * The Hilbert curve, of which consecutive cells are always adjacent.
+		 */
+		Hilbert = 2
+	};
+
+	/**
+	 * Compute the cells of a grid in the order of the given curve.
+	 *
+	 * Curves other than {@link SpaceFillingCurve::Scanline} are defined on a
+	 * square grid with a power of two side, so for other grids, the cells
+	 * outside the grid are skipped.
+	 *
+	 * @param[in] curve The curve to follow.
+	 * @param[in] width The width of the grid.
+	 * @param[in] height The height of the grid.
+	 * @return The coordinates of all cells of the grid in order.
+	 */
+	std::vector<glm::ivec2> curve_points(traceur::SpaceFillingCurve, int, int);
+
+	/**
+	 * Return the name of the given curve.
+	 *
+	 * @param[in] curve The curve.
+	 * @return The name of the curve.
+	 */
+	const char * curve_name(traceur::SpaceFillingCurve);
+
+	/**
+	 * Parse the name of a curve.
+	 *
+	 * @param[in] name The name of the curve.
+	 * @param[out] curve The parsed curve.
+	 * @return <code>true</code> if the name is known, otherwise
+	 * <code>false</code>.
+	 */
+	bool parse_curve(const std::string &, traceur::SpaceFillingCurve &);
+}
+
+#endif /* TRACEUR_CORE_KERNEL_CURVE_H */
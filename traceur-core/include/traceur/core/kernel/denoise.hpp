@@ -0,0 +1,165 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_DENOISE_H
+#define TRACEUR_CORE_KERNEL_DENOISE_H
+
+#include <memory>
+#include <vector>
+
+#include <traceur/core/kernel/film.hpp>
+#include <traceur/core/kernel/multithreaded.hpp>
+#include <traceur/core/kernel/observer.hpp>
+
+namespace traceur {
+	/**
+	 * An edge-avoiding à-trous wavelet filter that removes the noise of a
+	 * rendered {@link Film}.
+	 *
+	 * Every iteration of the filter convolves the image with a 5x5 B3-spline
+	 * kernel whose taps lie <code>2^i</code> pixels apart, so that large
+	 * neighbourhoods are covered with few taps. The taps are weighted by the
+	 * similarity of their color, albedo, normal and depth to those of the
+	 * filtered pixel, which preserves the edges of the geometry and textures
+	 * that the {@link Channels::Auxiliary} channels of the film describe.
+	 */
+	class Denoiser {
+	public:
+		/**
+		 * The amount of iterations of the filter.
+		 */
+		int iterations;
+
+		/**
+		 * The sensitivity of the weights to color differences, which is
+		 * halved after every iteration.
+		 */
+		float colorPhi;
+
+		/**
+		 * The exponent of the cosine between the normals of two pixels.
+		 */
+		float normalPhi;
+
+		/**
+		 * The sensitivity of the weights to depth differences relative to
+		 * the depth of the filtered pixel.
+		 */
+		float depthPhi;
+
+		/**
+		 * The sensitivity of the weights to albedo differences.
+		 */
+		float albedoPhi;
+
+		/**
+		 * The width and height of the tiles that are filtered in parallel.
+		 */
+		int tileSize;
+
+		/**
+		 * Construct a {@link Denoiser} instance.
+		 *
+		 * @param[in] workers The amount of worker threads that filter the
+		 * tiles of a film.
+		 */
+		Denoiser(int);
+
+		/**
+		 * Filter the given {@link Film} using its auxiliary channels.
+		 *
+		 * @param[in] film The film to filter.
+		 * @return The filtered film, which only depends on the color of the
+		 * film if it does not hold the auxiliary channels.
+		 */
+		std::unique_ptr<traceur::DirectFilm> denoise(const traceur::Film &) const;
+	private:
+		/**
+		 * The thread pool that filters the tiles of a film.
+		 */
+		mutable traceur::MultithreadedKernelPool pool;
+	};
+
+	/**
+	 * A {@link KernelObserver} that denoises the result of a render job
+	 * when it is finished and passes the denoised film on to the observers
+	 * attached to it.
+	 */
+	class DenoisingObserver: public KernelObserver {
+	public:
+		/**
+		 * Construct a {@link DenoisingObserver} instance.
+		 *
+		 * @param[in] denoiser The denoiser to use.
+		 */
+		DenoisingObserver(std::shared_ptr<traceur::Denoiser> denoiser) : denoiser(denoiser) {}
+
+		/**
+		 * This method is invoked when a render job is finished on the kernel.
+		 *
+		 * @param[in] kernel The kernel that is rendering the scene.
+		 * @param[in] film The {@link Film} the kernel has rendered the scene on.
+		 */
+		virtual void renderFinished(const traceur::Kernel &,
+									const traceur::Film &) override final;
+
+		/**
+		 * Add an observer that is notified with the denoised film when a
+		 * render job is finished.
+		 *
+		 * @param[in] observer The observer to add.
+		 */
+		inline void add_observer(std::shared_ptr<traceur::KernelObserver> observer)
+		{
+			observers.push_back(observer);
+		}
+
+		/**
+		 * Return the denoised result of the last render job.
+		 *
+		 * @return The denoised film or <code>nullptr</code> if no render job
+		 * has finished yet.
+		 */
+		inline const traceur::DirectFilm * result() const
+		{
+			return m_result.get();
+		}
+	private:
+		/**
+		 * The denoiser to use.
+		 */
+		std::shared_ptr<traceur::Denoiser> denoiser;
+
+		/**
+		 * The observers that are notified with the denoised film.
+		 */
+		std::vector<std::shared_ptr<traceur::KernelObserver>> observers;
+
+		/**
+		 * The denoised result of the last render job.
+		 */
+		std::unique_ptr<traceur::DirectFilm> m_result;
+	};
+}
+
+#endif /* TRACEUR_CORE_KERNEL_DENOISE_H */
@@ -25,10 +25,14 @@
 #define TRACEUR_CORE_KERNEL_FILM_H
 
 #include <algorithm>
+#include <cstdint>
+#include <limits>
 #include <memory>
+#include <tuple>
 #include <vector>
 
 #include <glm/glm.hpp>
+#include <traceur/core/kernel/channel.hpp>
 #include <traceur/core/kernel/pixel.hpp>
 
 namespace traceur {
@@ -102,6 +106,106 @@ namespace traceur {
 			return this->operator()(glm::ivec2(x, y));
 		}
 
+		/**
+		 * Return the channels this film holds besides the color of its
+		 * pixels.
+		 *
+		 * @return The mask of {@link Channels::Channel} values of the film.
+		 */
+		virtual unsigned channels() const
+		{
+			return 0;
+		}
+
+		/**
+		 * Return a pointer to the value of a channel of a pixel in this film.
+		 *
+		 * @param[in] channel The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return A pointer to the value of type
+		 * {@link ChannelTraits::type} or <code>nullptr</code> if the film
+		 * does not hold the channel at the given position.
+		 */
+		virtual const void * element(traceur::Channels::Channel, const glm::ivec2 &) const
+		{
+			return nullptr;
+		}
+
+		/**
+		 * Return the value of a channel of a pixel in this film.
+		 *
+		 * @tparam C The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return The value of the channel, which is empty if the film does
+		 * not hold the channel.
+		 */
+		template<traceur::Channels::Channel C>
+		typename traceur::ChannelTraits<C>::type channel(const glm::ivec2 &pos) const
+		{
+			using Type = typename traceur::ChannelTraits<C>::type;
+			auto value = static_cast<const Type *>(element(C, pos));
+			return value ? *value : traceur::ChannelTraits<C>::empty();
+		}
+
+		/**
+		 * Return the plane of a channel of this film if the film stores it
+		 * contiguously. The plane holds the values of the pixels row by row.
+		 *
+		 * @param[in] channel The channel to return the plane of.
+		 * @return A pointer to the values of type {@link ChannelTraits::type}
+		 * or <code>nullptr</code> if the film does not hold the channel or
+		 * does not store it contiguously.
+		 */
+		virtual const void * data(traceur::Channels::Channel) const
+		{
+			return nullptr;
+		}
+
+		/**
+		 * Copy the values of a channel of the pixels in this film row by row
+		 * into the given array. Pixels of which the film does not hold the
+		 * channel receive the empty value of the channel.
+		 *
+		 * @param[in] channel The channel to copy.
+		 * @param[out] values The array of <code>width * height</code> values
+		 * of type {@link ChannelTraits::type} to copy the channel into.
+		 */
+		virtual void read(traceur::Channels::Channel channel, void *values) const
+		{
+			traceur::visit_channel(channel, [&](auto tag) {
+				constexpr auto C = decltype(tag)::value;
+				using Type = typename traceur::ChannelTraits<C>::type;
+				auto output = static_cast<Type *>(values);
+				for (int y = 0; y < height; y++) {
+					for (int x = 0; x < width; x++) {
+						*output++ = this->template channel<C>(glm::ivec2(x, y));
+					}
+				}
+			});
+		}
+
+		/**
+		 * Return the plane of a channel of this film, which holds the values
+		 * of the pixels row by row. The channel is copied into the given
+		 * storage if the film does not store it contiguously, so the values
+		 * can be read without a virtual call per pixel.
+		 *
+		 * @tparam C The channel to return the plane of.
+		 * @param[in] storage The storage of the copy of the plane.
+		 * @return A pointer to the <code>width * height</code> values of the
+		 * channel, which is valid as long as the film and the storage are.
+		 */
+		template<traceur::Channels::Channel C>
+		const typename traceur::ChannelTraits<C>::type * plane(std::vector<typename traceur::ChannelTraits<C>::type> &storage) const
+		{
+			using Type = typename traceur::ChannelTraits<C>::type;
+			if (auto values = static_cast<const Type *>(data(C))) {
+				return values;
+			}
+			storage.resize(static_cast<size_t>(std::max(0, width * height)));
+			read(C, storage.data());
+			return storage.data();
+		}
 	};
 
 	/**
@@ -113,6 +217,47 @@ namespace traceur {
 		 * The buffer to which we write.
 		 */
 		std::vector<traceur::Pixel> buffer;
+
+		/**
+		 * The planes of the channels of the film, which are only allocated
+		 * when a kernel enables them.
+		 */
+		traceur::ChannelPlanes planes;
+
+		/**
+		 * The mask of the channels that are enabled.
+		 */
+		unsigned m_channels;
+
+		/**
+		 * Allocate the plane of a channel if it is in the given mask.
+		 *
+		 * @tparam C The channel to allocate.
+		 * @param[in] channels The mask of channels to allocate.
+		 */
+		template<traceur::Channels::Channel C>
+		inline void allocate(unsigned channels)
+		{
+			if ((channels & C) && !(m_channels & C)) {
+				std::get<traceur::ChannelTraits<C>::index>(planes).assign(buffer.size(), traceur::ChannelTraits<C>::empty());
+				m_channels |= C;
+			}
+		}
+
+		/**
+		 * Return a pointer to the value of a channel of a pixel if the
+		 * channel is enabled.
+		 *
+		 * @tparam C The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return A pointer to the value or <code>nullptr</code>.
+		 */
+		template<traceur::Channels::Channel C>
+		inline const void * pointer(const glm::ivec2 &pos) const
+		{
+			auto &plane = std::get<traceur::ChannelTraits<C>::index>(planes);
+			return plane.empty() ? nullptr : &plane[pos.y * width + pos.x];
+		}
 	public:
 		/**
 		 * Construct a {@link DirectFilm} instance.
@@ -121,7 +266,7 @@ namespace traceur {
 		 * @param[in] height The height of the film.
 		 */
 		DirectFilm(int width, int height) :
-			Film(width, height), buffer(static_cast<size_t>(std::max(0, width * height))) {}
+			Film(width, height), buffer(static_cast<size_t>(std::max(0, width * height))), m_channels(0) {}
 
 		/**
 		 * Return the reference to a {@link Pixel} in this film.
@@ -145,6 +290,159 @@ namespace traceur {
 			return buffer[pos.y * width + pos.x];
 		}
 
+		/**
+		 * Allocate the planes of the given channels, so a kernel can write
+		 * them. Channels that are already enabled keep their values.
+		 *
+		 * @param[in] channels The mask of {@link Channels::Channel} values
+		 * to enable.
+		 */
+		void enable(unsigned channels)
+		{
+			allocate<traceur::Channels::Depth>(channels);
+			allocate<traceur::Channels::Normal>(channels);
+			allocate<traceur::Channels::Albedo>(channels);
+			allocate<traceur::Channels::PrimitiveId>(channels);
+			allocate<traceur::Channels::MaterialId>(channels);
+			allocate<traceur::Channels::SampleCount>(channels);
+		}
+
+		/**
+		 * Return the reference to the value of a channel of a pixel in this
+		 * film. The channel must be enabled.
+		 *
+		 * @tparam C The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return A reference to the value of the channel.
+		 */
+		template<traceur::Channels::Channel C>
+		inline typename traceur::ChannelTraits<C>::type & channel(const glm::ivec2 &pos)
+		{
+			return std::get<traceur::ChannelTraits<C>::index>(planes)[pos.y * width + pos.x];
+		}
+
+		/**
+		 * Return the value of a channel of a pixel in this film.
+		 *
+		 * @tparam C The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return The value of the channel, which is empty if the channel is
+		 * not enabled.
+		 */
+		template<traceur::Channels::Channel C>
+		inline typename traceur::ChannelTraits<C>::type channel(const glm::ivec2 &pos) const
+		{
+			auto &plane = std::get<traceur::ChannelTraits<C>::index>(planes);
+			return plane.empty() ? traceur::ChannelTraits<C>::empty() : plane[pos.y * width + pos.x];
+		}
+
+		/**
+		 * Return the channels this film holds besides the color of its
+		 * pixels.
+		 *
+		 * @return The mask of {@link Channels::Channel} values of the film.
+		 */
+		inline virtual unsigned channels() const final
+		{
+			return m_channels;
+		}
+
+		/**
+		 * Return a pointer to the value of a channel of a pixel in this film.
+		 *
+		 * @param[in] channel The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return A pointer to the value or <code>nullptr</code> if the
+		 * channel is not enabled.
+		 */
+		virtual const void * element(traceur::Channels::Channel channel, const glm::ivec2 &pos) const final
+		{
+			switch (channel) {
+				case traceur::Channels::Depth:
+					return pointer<traceur::Channels::Depth>(pos);
+				case traceur::Channels::Normal:
+					return pointer<traceur::Channels::Normal>(pos);
+				case traceur::Channels::Albedo:
+					return pointer<traceur::Channels::Albedo>(pos);
+				case traceur::Channels::PrimitiveId:
+					return pointer<traceur::Channels::PrimitiveId>(pos);
+				case traceur::Channels::MaterialId:
+					return pointer<traceur::Channels::MaterialId>(pos);
+				case traceur::Channels::SampleCount:
+					return pointer<traceur::Channels::SampleCount>(pos);
+				default:
+					return nullptr;
+			}
+		}
+
+		/**
+		 * Return the plane of a channel of this film, which holds the values
+		 * of the pixels row by row.
+		 *
+		 * @param[in] channel The channel to return the plane of.
+		 * @return A pointer to the values or <code>nullptr</code> if the
+		 * channel is not enabled.
+		 */
+		virtual const void * data(traceur::Channels::Channel channel) const final
+		{
+			return traceur::visit_channel(channel, [&](auto tag) -> const void * {
+				auto &plane = std::get<traceur::ChannelTraits<decltype(tag)::value>::index>(planes);
+				return plane.empty() ? nullptr : plane.data();
+			});
+		}
+
+		/**
+		 * Copy the values of a channel of the pixels in this film row by row
+		 * into the given array.
+		 *
+		 * @param[in] channel The channel to copy.
+		 * @param[out] values The array of <code>width * height</code> values
+		 * to copy the channel into, which receives empty values if the
+		 * channel is not enabled.
+		 */
+		virtual void read(traceur::Channels::Channel channel, void *values) const final
+		{
+			traceur::visit_channel(channel, [&](auto tag) {
+				constexpr auto C = decltype(tag)::value;
+				using Type = typename traceur::ChannelTraits<C>::type;
+				auto &plane = std::get<traceur::ChannelTraits<C>::index>(planes);
+				auto output = static_cast<Type *>(values);
+				if (plane.empty()) {
+					std::fill(output, output + buffer.size(), traceur::ChannelTraits<C>::empty());
+				} else {
+					std::copy(plane.begin(), plane.end(), output);
+				}
+			});
+		}
+
+		/**
+		 * Copy the colors and the channels of the given film into this film,
+		 * of which the channels the given film holds are enabled.
+		 *
+		 * @param[in] film The film to copy, which must have the same
+		 * dimensions as this film.
+		 */
+		void assign(const traceur::Film &film)
+		{
+			for (int y = 0; y < height; y++) {
+				for (int x = 0; x < width; x++) {
+					buffer[y * width + x] = film(glm::ivec2(x, y));
+				}
+			}
+
+			unsigned channels = film.channels();
+			enable(channels);
+			for (unsigned channel = 1; channel & traceur::Channels::All; channel <<= 1) {
+				if (!(channels & channel)) {
+					continue;
+				}
+				traceur::visit_channel(static_cast<traceur::Channels::Channel>(channel), [&](auto tag) {
+					auto &plane = std::get<traceur::ChannelTraits<decltype(tag)::value>::index>(planes);
+					film.read(decltype(tag)::value, plane.data());
+				});
+			}
+		}
+
 		/**
 		 * Return the frame buffer of this film.
 		 *
@@ -166,6 +464,100 @@ namespace traceur {
 		}
 	};
 
+	/**
+	 * A {@link DirectFilm} that holds the running mean of multiple films, which
+	 * is used to accumulate the passes of a progressive render job.
+	 */
+	class AccumulationFilm: public DirectFilm {
+	public:
+		/**
+		 * The amount of films that have been accumulated.
+		 */
+		int passes;
+
+		/**
+		 * Construct a {@link AccumulationFilm} instance.
+		 *
+		 * @param[in] width The width of the film.
+		 * @param[in] height The height of the film.
+		 */
+		AccumulationFilm(int width, int height) : DirectFilm(width, height), passes(0) {}
+
+		/**
+		 * Accumulate the given film into this film.
+		 *
+		 * @param[in] film The film to accumulate, which must have the same
+		 * dimensions as this film.
+		 */
+		void accumulate(const traceur::Film &film)
+		{
+			float weight = 1.f / ++passes;
+			for (int y = 0; y < height; y++) {
+				for (int x = 0; x < width; x++) {
+					auto pos = glm::ivec2(x, y);
+					auto &pixel = this->operator()(pos);
+					pixel += (film(pos) - pixel) * weight;
+				}
+			}
+
+			unsigned channels = film.channels();
+			if (!channels) {
+				return;
+			}
+
+			// the attributes of the surfaces are averaged like the colors,
+			// while the identifiers of the first pass that saw a surface are
+			// kept and the sample counts are summed
+			enable(channels);
+			merge<traceur::Channels::Depth>(film, [&](float &depth, float value) {
+				depth += (value - depth) * weight;
+			});
+			merge<traceur::Channels::Normal>(film, [&](traceur::HalfNormal &normal, const traceur::HalfNormal &value) {
+				glm::vec3 mean = normal;
+				normal = mean + (glm::vec3(value) - mean) * weight;
+			});
+			merge<traceur::Channels::Albedo>(film, [&](glm::vec3 &albedo, const glm::vec3 &value) {
+				albedo += (value - albedo) * weight;
+			});
+			auto first = [](uint32_t &id, uint32_t value) {
+				if (id == std::numeric_limits<uint32_t>::max()) {
+					id = value;
+				}
+			};
+			merge<traceur::Channels::PrimitiveId>(film, first);
+			merge<traceur::Channels::MaterialId>(film, first);
+			merge<traceur::Channels::SampleCount>(film, [](uint16_t &count, uint16_t value) {
+				count = static_cast<uint16_t>(std::min<int>(count + value, std::numeric_limits<uint16_t>::max()));
+			});
+		}
+	private:
+		/**
+		 * Merge a channel of the given film into the channel of this film, of
+		 * which the plane is read once.
+		 *
+		 * @tparam C The channel to merge.
+		 * @param[in] film The film to merge, which must have the same
+		 * dimensions as this film.
+		 * @param[in] merge The function that merges a value of the given film
+		 * into the value of this film.
+		 */
+		template<traceur::Channels::Channel C, class Merge>
+		void merge(const traceur::Film &film, Merge merge)
+		{
+			if (!(film.channels() & C)) {
+				return;
+			}
+
+			std::vector<typename traceur::ChannelTraits<C>::type> storage;
+			auto values = film.plane<C>(storage);
+			for (int y = 0; y < height; y++) {
+				for (int x = 0; x < width; x++) {
+					merge(channel<C>(glm::ivec2(x, y)), values[y * width + x]);
+				}
+			}
+		}
+	};
+
 	/**
 	 * A {@link Film} that is partitioned in multiple subfilms on which parts
 	 * of the scene are projected via a raytracing {@link Kernel}.
@@ -257,6 +649,18 @@ namespace traceur {
 			return *partitions[n];
 		}
 
+		/**
+		 * Return the amount of columns and rows of partitions in this film.
+		 * The partition in a column and row is numbered
+		 * <code>row * columns + column</code>.
+		 *
+		 * @return The amount of columns and rows.
+		 */
+		inline glm::ivec2 grid() const
+		{
+			return { columns, rows };
+		}
+
 		/**
 		 * Return the offset of a particular partition within the film.
 		 *
@@ -298,6 +702,66 @@ namespace traceur {
 			int n = i * columns + j;
 			return partitions[n]->operator()(pos - offset(n));
 		}
+
+		/**
+		 * Return the channels the partitions of this film hold besides the
+		 * color of their pixels.
+		 *
+		 * @return The mask of {@link Channels::Channel} values of the film.
+		 */
+		inline virtual unsigned channels() const final
+		{
+			unsigned channels = 0;
+			for (auto &partition : partitions) {
+				channels |= partition->channels();
+			}
+			return channels;
+		}
+
+		/**
+		 * Return a pointer to the value of a channel of a pixel in this film.
+		 *
+		 * @param[in] channel The channel to return the value of.
+		 * @param[in] pos The position within the film.
+		 * @return A pointer to the value or <code>nullptr</code> if the
+		 * partition of the pixel does not hold the channel.
+		 */
+		inline virtual const void * element(traceur::Channels::Channel channel, const glm::ivec2 &pos) const final
+		{
+			int j = std::min(pos.x / px, columns - 1);
+			int i = std::min(pos.y / py, rows - 1);
+			int n = i * columns + j;
+			return partitions[n]->element(channel, pos - offset(n));
+		}
+
+		/**
+		 * Copy the values of a channel of the pixels in this film row by row
+		 * into the given array, of which the planes of the partitions are
+		 * read once.
+		 *
+		 * @param[in] channel The channel to copy.
+		 * @param[out] values The array of <code>width * height</code> values
+		 * to copy the channel into, which receives empty values for the
+		 * partitions that do not hold the channel.
+		 */
+		virtual void read(traceur::Channels::Channel channel, void *values) const final
+		{
+			traceur::visit_channel(channel, [&](auto tag) {
+				constexpr auto C = decltype(tag)::value;
+				using Type = typename traceur::ChannelTraits<C>::type;
+				auto output = static_cast<Type *>(values);
+				std::vector<Type> storage;
+				for (int k = 0; k < n; k++) {
+					auto &partition = *partitions[k];
+					auto plane = partition.template plane<C>(storage);
+					auto origin = offset(k);
+					for (int y = 0; y < partition.height; y++) {
+						std::copy(plane + y * partition.width, plane + (y + 1) * partition.width,
+								  output + (origin.y + y) * width + origin.x);
+					}
+				}
+			});
+		}
 	};
 }
 #endif /* TRACEUR_CORE_KERNEL_FILM_H */
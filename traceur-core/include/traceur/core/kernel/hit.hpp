@@ -46,8 +46,19 @@ namespace traceur {
 		 */
 		float distance;
 
+		/**
+		 * The barycentric coordinates of the hit on the {@link Primitive},
+		 * relative to its second and third vertex (if applicable).
+		 */
+		float u, v;
+
 		/**
 		 * The position of the hit within the scene.
+		 *
+		 * Traversal only records the distance, the primitive and the
+		 * barycentric coordinates of a candidate hit. The position and normal
+		 * are computed for the nearest hit by
+		 * {@link Primitive#finalize(const Ray &, Hit &)}.
 		 */
 		glm::vec3 position;
 
@@ -29,10 +29,17 @@
 
 #include <traceur/core/kernel/film.hpp>
 #include <traceur/core/kernel/observer.hpp>
+#include <traceur/core/kernel/statistics.hpp>
 #include <traceur/core/scene/scene.hpp>
 #include <traceur/core/scene/camera.hpp>
 
 namespace traceur {
+	/**
+	 * The pass index of a render job that is not part of a progressive
+	 * render job.
+	 */
+	const int singlePass = -1;
+
 	/**
 	 * This class represents an interface for a raytracing kernel supported by
 	 * the Traceur project.
@@ -79,6 +86,45 @@ namespace traceur {
 							traceur::Film &,
 							const glm::ivec2 &) const = 0;
 
+		/**
+		 * Render a single pass of a progressive render job of the given
+		 * {@link Scene} into a {@link Film}.
+		 *
+		 * Kernels that support progressive rendering take different samples
+		 * for each pass, so that the mean of the passes converges. By default,
+		 * the pass is ignored and the regular render job is performed.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] pass The index of the pass to render.
+		 * @return A {@link Film} of the scene to take ownership over.
+		 */
+		virtual std::unique_ptr<traceur::Film> render(const traceur::Scene &scene,
+													  const traceur::Camera &camera,
+													  int) const
+		{
+			return render(scene, camera);
+		}
+
+		/**
+		 * Render a single pass of a progressive render job of a part of the
+		 * given {@link Scene} into the {@link Film} passed to this function.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] film The film to render the scene into.
+		 * @param[in] offset The offset of the screen.
+		 * @param[in] pass The index of the pass to render.
+		 */
+		virtual void render(const traceur::Scene &scene,
+							const traceur::Camera &camera,
+							traceur::Film &film,
+							const glm::ivec2 &offset,
+							int) const
+		{
+			render(scene, camera, film, offset);
+		}
+
 		/**
 		 * Return the name of this kernel.
 		 *
@@ -86,6 +132,17 @@ namespace traceur {
 		 */
 		virtual const std::string & name() const = 0;
 
+		/**
+		 * Return a snapshot of the statistics this kernel has collected over
+		 * all render jobs so far.
+		 *
+		 * @return The statistics of this kernel.
+		 */
+		virtual traceur::KernelStatistics statistics() const
+		{
+			return traceur::KernelStatistics();
+		}
+
 	protected:
 		/**
 		 * The observers of the kernel.
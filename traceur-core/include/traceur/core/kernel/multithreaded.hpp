@@ -31,6 +31,7 @@
 #include <mutex>
 #include <condition_variable>
 
+#include <traceur/core/kernel/curve.hpp>
 #include <traceur/core/kernel/kernel.hpp>
 #include <traceur/core/kernel/pixel.hpp>
 
@@ -151,6 +152,12 @@ namespace traceur {
 		 */
 		std::pair<int, int> range;
 
+		/**
+		 * The order in which the partitions are scheduled, so that
+		 * partitions rendered at the same time lie close together.
+		 */
+		traceur::SpaceFillingCurve partitionOrder;
+
 		/**
 		 * Construct a {@link MultithreadedKernel}.
 		 *
@@ -188,7 +195,8 @@ namespace traceur {
 		 * Render a part of the given {@link Scene} into the {@link Film}
 		 * passed to this function.
 		 *
-		 * NOTE: This method does not work with multiple threads.
+		 * The part is divided into partitions of its own, which are rendered
+		 * by the thread pool.
 		 *
 		 * @param[in] scene The {@link Scene} to render.
 		 * @param[in] camera The {@link Camera} to use.
@@ -200,6 +208,38 @@ namespace traceur {
 							traceur::Film &,
 							const glm::ivec2 &) const final;
 
+		/**
+		 * Render a single pass of a progressive render job of the given
+		 * {@link Scene} into a {@link Film}.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] pass The index of the pass to render.
+		 * @return A {@link Film} of the scene to take ownership over.
+		 */
+		virtual std::unique_ptr<traceur::Film> render(const traceur::Scene &,
+													  const traceur::Camera &,
+													  int) const final;
+
+		/**
+		 * Render a single pass of a progressive render job of a part of the
+		 * given {@link Scene} into the {@link Film} passed to this function.
+		 *
+		 * The part is divided into partitions of its own, which are rendered
+		 * by the thread pool.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] film The film to render the scene into.
+		 * @param[in] offset The offset of the screen.
+		 * @param[in] pass The index of the pass to render.
+		 */
+		virtual void render(const traceur::Scene &,
+							const traceur::Camera &,
+							traceur::Film &,
+							const glm::ivec2 &,
+							int) const final;
+
 		/**
 		 * Return the name of this kernel.
 		 *
@@ -212,6 +252,16 @@ namespace traceur {
 											+ std::to_string(partitions);
 			return name;
 		}
+
+		/**
+		 * Return a snapshot of the statistics of the underlying kernel.
+		 *
+		 * @return The statistics of the underlying kernel.
+		 */
+		virtual traceur::KernelStatistics statistics() const final
+		{
+			return kernel->statistics();
+		}
 	private:
 		/**
 		 * The underlying kernel to use.
@@ -222,6 +272,25 @@ namespace traceur {
 		 * The thread pool the kernel uses.
 		 */
 		mutable traceur::MultithreadedKernelPool pool;
+
+		/**
+		 * Render a range of the partitions of the given film on the thread
+		 * pool and wait for them to finish.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] film The partitioned film to render the scene into.
+		 * @param[in] offset The offset of the film on the screen.
+		 * @param[in] pass The index of the pass to render.
+		 * @param[in] range The range of partitions to render in format
+		 * [from, end].
+		 */
+		void renderPartitions(const traceur::Scene &,
+							  const traceur::Camera &,
+							  traceur::PartitionedFilm<traceur::DirectFilm> &,
+							  const glm::ivec2 &,
+							  int,
+							  std::pair<int, int>) const;
 	};
 }
 
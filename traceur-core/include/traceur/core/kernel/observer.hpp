@@ -89,6 +89,19 @@ namespace traceur {
 									   const traceur::Film &,
 									   const glm::ivec2 &) {}
 
+		/**
+		 * This method is invoked when a pass of a progressive render job is
+		 * finished on the kernel.
+		 *
+		 * @param[in] kernel The kernel that is rendering the scene.
+		 * @param[in] pass The index of the pass that has finished.
+		 * @param[in] film The {@link Film} containing the result of all
+		 * passes so far.
+		 */
+		virtual void passFinished(const traceur::Kernel &,
+								  int,
+								  const traceur::Film &) {}
+
 		/**
 		 * This method is invoked when a render job is finished on the kernel.
 		 *
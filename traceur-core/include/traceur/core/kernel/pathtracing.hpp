@@ -0,0 +1,169 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_PATHTRACING_H
+#define TRACEUR_CORE_KERNEL_PATHTRACING_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <traceur/core/kernel/basic.hpp>
+#include <traceur/core/lightning/area.hpp>
+
+namespace traceur {
+	/**
+	 * A {@link BasicKernel} that renders the global illumination of a scene
+	 * by path tracing.
+	 *
+	 * The materials are sampled as a mixture of a Lambertian lobe for the
+	 * diffuse term and a normalised Blinn-Phong lobe for the specular term of
+	 * illumination model 2. The specular term of the reflecting illumination
+	 * models is an ideal mirror, and the refracting and transparent models
+	 * transmit as in the basic kernel.
+	 *
+	 * At every vertex of a path, a point on an emissive triangle and every
+	 * point light are connected to the vertex through any-hit shadow rays.
+	 * The contributions of the emissive triangles that are found by both
+	 * these connections and by the sampled directions are weighted by the
+	 * power heuristic. The point lights are isotropic sources of unit
+	 * intensity.
+	 *
+	 * The kernel shares the pixel loop of the basic kernel, so it supports
+	 * the same anti-aliasing, progressive passes, partitioning and observers.
+	 */
+	class PathTracingKernel: public BasicKernel {
+	public:
+		/**
+		 * The maximum amount of bounces of a path.
+		 */
+		int maxDepth;
+
+		/**
+		 * The amount of bounces after which paths are terminated by Russian
+		 * roulette.
+		 */
+		int rouletteDepth;
+
+		/**
+		 * Construct a {@link PathTracingKernel} instance which samples the
+		 * paths with an Owen-scrambled Sobol sequence.
+		 */
+		PathTracingKernel();
+
+		/**
+		 * Construct a {@link PathTracingKernel} instance.
+		 *
+		 * @param[in] sampler The sampler to use.
+		 * @param[in] maxDepth The maximum amount of bounces of a path.
+		 */
+		PathTracingKernel(std::shared_ptr<traceur::Sampler>, int);
+
+		/**
+		 * Return the name of this kernel.
+		 *
+		 * @return A string representing the name of this kernel.
+		 */
+		virtual const std::string & name() const final
+		{
+			static const std::string name = "path-tracing";
+			return name;
+		}
+	protected:
+		/**
+		 * Prepare the state of a render job by replacing the function that
+		 * traces the rays of the job with the path tracer for the graph of
+		 * the given {@link Scene} and the active instruction set, and collect the emissive triangles of the
+		 * scene if its generation or the emissions of its materials have
+		 * changed since the previous render job.
+		 *
+		 * @param[in] scene The {@link Scene} that is going to be rendered.
+		 * @param[in] state The state of the render job.
+		 */
+		virtual void prepare(const traceur::Scene &, traceur::RenderState &) const final;
+	private:
+		/**
+		 * Estimate the radiance that arrives along a ray by tracing a path
+		 * from the ray through the {@link Scene}.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @param[in] scene The scene to trace the path through.
+		 * @param[in] camera The camera that captures the scene.
+		 * @param[in] ray The ray to start the path with.
+		 * @param[in] depth The depth of the recursion, which is unused.
+		 * @param[in] state The state of the render job.
+		 * @return The radiance that arrives along the ray.
+		 */
+		template<class Graph>
+		traceur::Pixel radiance(const traceur::Scene &,
+								const traceur::Camera &,
+								const traceur::Ray &,
+								int,
+								traceur::RenderState &) const;
+
+		/**
+		 * Estimate the radiance that arrives along a ray with the path
+		 * tracer compiled for the given instruction set.
+		 *
+		 * @tparam Graph The type of the graph of the scene.
+		 * @tparam I The instruction set to compile the path tracer for.
+		 * @param[in] scene The scene to trace the path through.
+		 * @param[in] camera The camera that captures the scene.
+		 * @param[in] ray The ray to start the path with.
+		 * @param[in] depth The depth of the recursion, which is unused.
+		 * @param[in] state The state of the render job.
+		 * @return The radiance that arrives along the ray.
+		 */
+		template<class Graph, traceur::ISA I>
+		traceur::Pixel radianceVariant(const traceur::Scene &,
+									   const traceur::Camera &,
+									   const traceur::Ray &,
+									   int,
+									   traceur::RenderState &) const;
+
+		/**
+		 * The emissive triangles of the scene.
+		 */
+		mutable traceur::AreaLights m_emitters;
+
+		/**
+		 * The generation of the scene the emissive triangles were collected
+		 * from.
+		 */
+		mutable uint64_t m_generation;
+
+		/**
+		 * The emissions of the materials the emissive triangles were
+		 * collected with.
+		 */
+		mutable std::vector<glm::vec3> m_emissions;
+
+		/**
+		 * The lock protecting the emissive triangles of the kernel.
+		 */
+		mutable std::mutex m_mutex;
+	};
+}
+
+#endif /* TRACEUR_CORE_KERNEL_PATHTRACING_H */
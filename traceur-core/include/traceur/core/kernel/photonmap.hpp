@@ -0,0 +1,222 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_PHOTONMAP_H
+#define TRACEUR_CORE_KERNEL_PHOTONMAP_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
+
+#include <traceur/core/kernel/basic.hpp>
+#include <traceur/core/lightning/area.hpp>
+#include <traceur/core/lightning/photon.hpp>
+#include <traceur/core/scene/graph/query.hpp>
+
+namespace traceur {
+	/**
+	 * A {@link BasicKernel} that adds the caustics of the scene to the
+	 * diffuse illumination of a surface.
+	 *
+	 * Before the first render job of a scene, photons are shot from every
+	 * light and from the emissive triangles of the scene, and followed through the reflecting, refracting and transparent
+	 * surfaces of the scene. All photons advance one bounce at a time, so
+	 * that each bounce is traced as a single batch by a
+	 * {@link RayQueryEngine}. The photons that arrive at a diffuse surface
+	 * after at least one specular bounce are stored in a {@link PhotonMap},
+	 * which the render jobs query for the irradiance at every shading point.
+	 * The direct illumination is still evaluated by the shadow rays of the
+	 * basic kernel.
+	 *
+	 * The lights are treated as isotropic sources of unit intensity, so that
+	 * the caustics match the direct illumination of the basic kernel at unit
+	 * distance from a light. The emissive triangles together emit as many
+	 * photons as a single light, chosen in proportion to the power of each
+	 * triangle, and radiate their emission from both of their sides.
+	 */
+	class PhotonMapKernel: public BasicKernel {
+	public:
+		/**
+		 * The amount of photons that are emitted by each light, and by the
+		 * emissive triangles of the scene together.
+		 */
+		int photons;
+
+		/**
+		 * The amount of photons that a radiance estimate gathers.
+		 */
+		int neighbours;
+
+		/**
+		 * The maximum distance of a gathered photon to the shading point.
+		 */
+		float radius;
+
+		/**
+		 * The amount of worker threads that trace the photons.
+		 */
+		int workers;
+
+		/**
+		 * Construct a {@link PhotonMapKernel} instance which samples the
+		 * lights with an Owen-scrambled Sobol sequence.
+		 */
+		PhotonMapKernel();
+
+		/**
+		 * Construct a {@link PhotonMapKernel} instance.
+		 *
+		 * @param[in] sampler The sampler to use.
+		 * @param[in] lightSamples The amount of shadow rays per light.
+		 * @param[in] photons The amount of photons emitted by each light and
+		 * by the emissive triangles together.
+		 * @param[in] workers The amount of worker threads that trace the
+		 * photons.
+		 * @param[in] features The mask of {@link SceneFeatures::Feature}
+		 * values the kernel is specialized for.
+		 */
+		PhotonMapKernel(std::shared_ptr<traceur::Sampler>, int, int, int,
+						unsigned = traceur::SceneFeatures::All);
+
+		/**
+		 * Return the name of this kernel.
+		 *
+		 * @return A string representing the name of this kernel.
+		 */
+		virtual const std::string & name() const final
+		{
+			static const std::string name = "photon-map";
+			return name;
+		}
+	protected:
+		/**
+		 * Prepare the state of a render job by attaching the photon map of
+		 * the given {@link Scene}, which is built if the generation, the
+		 * lights or the emissive materials of the scene have changed since
+		 * the previous render job.
+		 *
+		 * @param[in] scene The {@link Scene} that is going to be rendered.
+		 * @param[in] state The state of the render job.
+		 */
+		virtual void prepare(const traceur::Scene &, traceur::RenderState &) const final;
+	private:
+		/**
+		 * A photon that is followed through the scene.
+		 */
+		struct Path {
+			/**
+			 * The ray along which the photon travels.
+			 */
+			traceur::Ray ray;
+
+			/**
+			 * The power the photon carries.
+			 */
+			glm::vec3 flux;
+
+			/**
+			 * The light that emitted the photon and the index of the photon,
+			 * which select the samples of the photon.
+			 */
+			glm::ivec2 pixel;
+			uint32_t index;
+
+			/**
+			 * A flag to indicate that the photon has been reflected or
+			 * refracted at a specular surface.
+			 */
+			bool specular;
+		};
+
+		/**
+		 * Emit a photon from a light into the {@link Scene}.
+		 *
+		 * @param[in] scene The {@link Scene} to emit the photon into.
+		 * @param[in] light The index of the light that emits the photon, or
+		 * the amount of lights to emit it from the emissive triangles.
+		 * @param[in] index The index of the photon.
+		 * @return The photon that has been emitted.
+		 */
+		Path emit(const traceur::Scene &, size_t, uint32_t) const;
+
+		/**
+		 * Store a photon at the surface it hit if it is a caustic, and
+		 * choose the specular event that continues its path.
+		 *
+		 * @param[in] scene The {@link Scene} the photon travels through.
+		 * @param[in] path The photon, which is updated to its next bounce.
+		 * @param[in] hit The surface the photon hit.
+		 * @param[in] bounce The index of the bounce.
+		 * @param[out] stored The photons that have been stored.
+		 * @return <code>true</code> if the photon continues, otherwise
+		 * <code>false</code>.
+		 */
+		bool scatter(const traceur::Scene &, Path &, const traceur::Hit &, int,
+					 std::vector<traceur::Photon> &) const;
+
+		/**
+		 * The engine that traces the bounces of the photons.
+		 */
+		mutable std::unique_ptr<traceur::RayQueryEngine> m_queries;
+
+		/**
+		 * The photon map of the caustics of the scene.
+		 */
+		mutable traceur::PhotonMap m_caustics;
+
+		/**
+		 * The emissive triangles of the scene the photon map was built for.
+		 */
+		mutable traceur::AreaLights m_emitters;
+
+		/**
+		 * The generation of the scene the photon map was built for.
+		 */
+		mutable uint64_t m_generation;
+
+		/**
+		 * The lights of the scene the photon map was built for.
+		 */
+		mutable std::vector<traceur::Light> m_lights;
+
+		/**
+		 * The emissions of the materials the photon map was built for.
+		 */
+		mutable std::vector<glm::vec3> m_emissions;
+
+		/**
+		 * The settings the photon map was built with, in the order photons,
+		 * neighbours and radius.
+		 */
+		mutable std::tuple<int, int, float> m_settings;
+
+		/**
+		 * The lock protecting the photon map of the kernel.
+		 */
+		mutable std::mutex m_mutex;
+	};
+}
+
+#endif /* TRACEUR_CORE_KERNEL_PHOTONMAP_H */
@@ -24,6 +24,9 @@
 #ifndef TRACEUR_CORE_KERNEL_PIXEL_H
 #define TRACEUR_CORE_KERNEL_PIXEL_H
 
+#include <cstdint>
+#include <limits>
+
 #include <glm/glm.hpp>
 
 namespace traceur {
@@ -32,6 +35,56 @@ namespace traceur {
 	 * green and blue channels.
 	 */
 	using Pixel = glm::vec3;
+
+	/**
+	 * The attributes of the surfaces that are seen through a pixel, which a
+	 * kernel gathers over the primary rays of the pixel and writes into the
+	 * channels of a film.
+	 */
+	struct AuxiliaryPixel {
+		/**
+		 * The sum of the diffuse albedo of the surfaces.
+		 */
+		glm::vec3 albedo;
+
+		/**
+		 * The sum of the normals of the surfaces, facing the camera.
+		 */
+		glm::vec3 normal;
+
+		/**
+		 * The sum of the distances from the camera to the surfaces.
+		 */
+		float depth;
+
+		/**
+		 * The identifier of the first primitive that is seen.
+		 */
+		uint32_t primitive;
+
+		/**
+		 * The index of the material of the first primitive that is seen.
+		 */
+		uint32_t material;
+
+		/**
+		 * Construct an empty {@link AuxiliaryPixel} instance.
+		 */
+		AuxiliaryPixel() :
+			albedo(0.f), normal(0.f), depth(0.f),
+			primitive(std::numeric_limits<uint32_t>::max()), material(std::numeric_limits<uint32_t>::max()) {}
+	};
+
+	/**
+	 * Return the relative luminance of the given color.
+	 *
+	 * @param[in] pixel The color to compute the luminance of.
+	 * @return The relative luminance of the color.
+	 */
+	inline float luminance(const traceur::Pixel &pixel)
+	{
+		return glm::dot(pixel, traceur::Pixel(0.2126f, 0.7152f, 0.0722f));
+	}
 }
 
 #endif /* TRACEUR_CORE_KERNEL_PIXEL_H */
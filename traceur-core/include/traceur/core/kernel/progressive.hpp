@@ -0,0 +1,133 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_PROGRESSIVE_H
+#define TRACEUR_CORE_KERNEL_PROGRESSIVE_H
+
+#include <memory>
+
+#include <traceur/core/kernel/kernel.hpp>
+
+namespace traceur {
+	/**
+	 * A {@link Kernel} that renders successive passes of another kernel and
+	 * accumulates them into a single film, until either the target amount of
+	 * passes is reached or the time budget is exhausted.
+	 *
+	 * The observers of this kernel are notified after every pass with the
+	 * result of all passes so far.
+	 */
+	class ProgressiveKernel: public Kernel {
+	public:
+		using traceur::Kernel::render;
+
+		/**
+		 * The amount of passes to render, or zero to render passes until the
+		 * time budget is exhausted.
+		 */
+		int passes;
+
+		/**
+		 * The wall-clock budget of a render job in seconds, or zero for no
+		 * budget. A pass is only started if it is expected to finish within
+		 * the budget, although at least one pass is always rendered. A part
+		 * of the screen receives the share of the budget of its area.
+		 */
+		double budget;
+
+		/**
+		 * Construct a {@link ProgressiveKernel} instance.
+		 *
+		 * @param[in] kernel The underlying kernel to render the passes with.
+		 * @param[in] passes The amount of passes to render.
+		 * @param[in] budget The time budget in seconds.
+		 */
+		ProgressiveKernel(const std::shared_ptr<traceur::Kernel>, int, double);
+
+		/**
+		 * Render the camera view of the given {@link Scene} into a
+		 * {@link Film}.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @return A {@link Film} of the scene to take ownership over.
+		 */
+		virtual std::unique_ptr<traceur::Film> render(const traceur::Scene &,
+													  const traceur::Camera &) const final;
+
+		/**
+		 * Render a part of the given {@link Scene} into the {@link Film}
+		 * passed to this function, within the share of the budget of the
+		 * area of the film on the screen.
+		 *
+		 * @param[in] scene The {@link Scene} to render.
+		 * @param[in] camera The {@link Camera} to use.
+		 * @param[in] film The film to render the scene into.
+		 * @param[in] offset The offset of the screen.
+		 */
+		virtual void render(const traceur::Scene &,
+							const traceur::Camera &,
+							traceur::Film &,
+							const glm::ivec2 &) const final;
+
+		/**
+		 * Return the name of this kernel.
+		 *
+		 * @return A string representing the name of this kernel.
+		 */
+		virtual const std::string & name() const final
+		{
+			static const std::string name = kernel->name() + "-progressive";
+			return name;
+		}
+
+		/**
+		 * Return a snapshot of the statistics of the underlying kernel.
+		 *
+		 * @return The statistics of the underlying kernel.
+		 */
+		virtual traceur::KernelStatistics statistics() const final
+		{
+			return kernel->statistics();
+		}
+	private:
+		/**
+		 * The underlying kernel to use.
+		 */
+		std::shared_ptr<traceur::Kernel> kernel;
+
+		/**
+		 * Determine whether another pass should be rendered.
+		 *
+		 * @param[in] pass The amount of passes that have been rendered.
+		 * @param[in] elapsed The time that has elapsed in seconds.
+		 * @param[in] budget The time budget in seconds, or zero for no
+		 * budget.
+		 * @return <code>true</code> if another pass should be rendered,
+		 * <code>false</code> otherwise.
+		 */
+		bool proceed(int, double, double) const;
+	};
+}
+
+#endif /* TRACEUR_CORE_KERNEL_PROGRESSIVE_H */
@@ -0,0 +1,154 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_KERNEL_STATISTICS_H
+#define TRACEUR_CORE_KERNEL_STATISTICS_H
+
+#include <cstdint>
+
+namespace traceur {
+	/**
+	 * A set of counters a {@link Kernel} collects while rendering a
+	 * {@link Scene}, which can be used to judge the effectiveness of the
+	 * optimisations in the kernel.
+	 */
+	class KernelStatistics {
+	public:
+		/**
+		 * The amount of shadow rays that have been cast.
+		 */
+		uint64_t shadowRays;
+
+		/**
+		 * The amount of shadow rays that were found to be occluded by the
+		 * cached occluder of the light, without traversing the scene graph.
+		 */
+		uint64_t occluderCacheHits;
+
+		/**
+		 * The amount of times the visibility of a light has been evaluated
+		 * while a {@link VisibilityCache} was in use.
+		 */
+		uint64_t visibilityQueries;
+
+		/**
+		 * The amount of visibility evaluations that were interpolated from
+		 * the {@link VisibilityCache} without casting shadow rays.
+		 */
+		uint64_t visibilityCacheHits;
+
+		/**
+		 * The amount of pixels that have been rendered.
+		 */
+		uint64_t pixels;
+
+		/**
+		 * The amount of primary rays (pixel samples) that have been traced.
+		 */
+		uint64_t primarySamples;
+
+		/**
+		 * The amount of pixels that received more than the initial amount of
+		 * samples.
+		 */
+		uint64_t refinedPixels;
+
+		/**
+		 * Construct a {@link KernelStatistics} instance.
+		 */
+		KernelStatistics() : shadowRays(0), occluderCacheHits(0), visibilityQueries(0), visibilityCacheHits(0), pixels(0), primarySamples(0), refinedPixels(0) {}
+
+		/**
+		 * Return the fraction of shadow rays that were resolved by the occluder
+		 * cache.
+		 *
+		 * @return The hit rate of the occluder cache in the range [0, 1].
+		 */
+		double occluderCacheHitRate() const
+		{
+			return shadowRays ? static_cast<double>(occluderCacheHits) / shadowRays : 0.0;
+		}
+
+		/**
+		 * Return the fraction of visibility evaluations that were resolved
+		 * by the visibility cache.
+		 *
+		 * @return The hit rate of the visibility cache in the range [0, 1].
+		 */
+		double visibilityCacheHitRate() const
+		{
+			return visibilityQueries ? static_cast<double>(visibilityCacheHits) / visibilityQueries : 0.0;
+		}
+
+		/**
+		 * Return the mean amount of samples per pixel.
+		 *
+		 * @return The mean amount of samples per pixel.
+		 */
+		double samplesPerPixel() const
+		{
+			return pixels ? static_cast<double>(primarySamples) / pixels : 0.0;
+		}
+
+		/**
+		 * Add the counters of another {@link KernelStatistics} instance to
+		 * this instance.
+		 *
+		 * @param[in] other The statistics to add.
+		 * @return A reference to this instance.
+		 */
+		KernelStatistics & operator+=(const KernelStatistics &other)
+		{
+			shadowRays += other.shadowRays;
+			occluderCacheHits += other.occluderCacheHits;
+			visibilityQueries += other.visibilityQueries;
+			visibilityCacheHits += other.visibilityCacheHits;
+			pixels += other.pixels;
+			primarySamples += other.primarySamples;
+			refinedPixels += other.refinedPixels;
+			return *this;
+		}
+
+		/**
+		 * Return the difference between the counters of this instance and
+		 * an earlier snapshot of the statistics.
+		 *
+		 * @param[in] other The earlier snapshot of the statistics.
+		 * @return The counters collected since the snapshot.
+		 */
+		KernelStatistics operator-(const KernelStatistics &other) const
+		{
+			KernelStatistics result;
+			result.shadowRays = shadowRays - other.shadowRays;
+			result.occluderCacheHits = occluderCacheHits - other.occluderCacheHits;
+			result.visibilityQueries = visibilityQueries - other.visibilityQueries;
+			result.visibilityCacheHits = visibilityCacheHits - other.visibilityCacheHits;
+			result.pixels = pixels - other.pixels;
+			result.primarySamples = primarySamples - other.primarySamples;
+			result.refinedPixels = refinedPixels - other.refinedPixels;
+			return result;
+		}
+	};
+}
+
+#endif /* TRACEUR_CORE_KERNEL_STATISTICS_H */
@@ -0,0 +1,141 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_LIGHTNING_AREA_H
+#define TRACEUR_CORE_LIGHTNING_AREA_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace traceur {
+	/* Forward declarations */
+	class Scene;
+
+	/**
+	 * A triangle of the scene whose material emits light.
+	 */
+	struct AreaLight {
+		/**
+		 * The first vertex of the triangle.
+		 */
+		glm::vec3 origin;
+
+		/**
+		 * The edges of the triangle from its first vertex.
+		 */
+		glm::vec3 u, v;
+
+		/**
+		 * The normal of the triangle.
+		 */
+		glm::vec3 normal;
+
+		/**
+		 * The radiance the triangle emits from both of its sides.
+		 */
+		glm::vec3 emission;
+
+		/**
+		 * The area of the triangle.
+		 */
+		float area;
+	};
+
+	/**
+	 * The emissive triangles of a {@link Scene}, which are sampled in
+	 * proportion to the power they emit.
+	 */
+	class AreaLights {
+	public:
+		/**
+		 * Construct an empty {@link AreaLights} instance.
+		 */
+		AreaLights() : power(0) {}
+
+		/**
+		 * Construct a {@link AreaLights} instance from the triangles of the
+		 * given {@link Scene} whose material has a non-zero emission.
+		 *
+		 * @param[in] scene The scene to collect the emissive triangles of.
+		 */
+		explicit AreaLights(const traceur::Scene &);
+
+		/**
+		 * Sample a point on one of the lights.
+		 *
+		 * @param[in] sample The sample value that selects the light.
+		 * @param[in] point The sample values that select the point on the
+		 * light.
+		 * @param[out] position The position of the point.
+		 * @return The light that has been sampled.
+		 */
+		const traceur::AreaLight & sample(float, const glm::vec2 &, glm::vec3 &) const;
+
+		/**
+		 * Return the probability density per unit area with which a point
+		 * on a light of the given emission is sampled.
+		 *
+		 * @param[in] emission The emission of the light.
+		 * @return The probability density of the point.
+		 */
+		float density(const glm::vec3 &) const;
+
+		/**
+		 * Determine whether the scene contains no emissive triangles.
+		 *
+		 * @return <code>true</code> if there are no lights, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool empty() const
+		{
+			return lights.empty();
+		}
+	private:
+		/**
+		 * The emissive triangles of the scene.
+		 */
+		std::vector<traceur::AreaLight> lights;
+
+		/**
+		 * The cumulative power of the lights up to and including each light.
+		 */
+		std::vector<float> cdf;
+
+		/**
+		 * The total power of the lights.
+		 */
+		float power;
+	};
+
+	/**
+	 * Collect the emission of every material of a {@link Scene}, which the
+	 * kernels compare to notice that the emissive triangles have changed.
+	 *
+	 * @param[in] scene The scene to collect the emissions of.
+	 * @return The emission of each material, in the order of the materials.
+	 */
+	std::vector<glm::vec3> material_emissions(const traceur::Scene &);
+}
+
+#endif /* TRACEUR_CORE_LIGHTNING_AREA_H */
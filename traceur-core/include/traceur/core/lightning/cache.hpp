@@ -0,0 +1,168 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_LIGHTNING_CACHE_H
+#define TRACEUR_CORE_LIGHTNING_CACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <traceur/core/lightning/light.hpp>
+
+namespace traceur {
+	/* Forward declarations */
+	class Scene;
+	class SceneGraph;
+
+	/**
+	 * A world-space cache of the visible fraction of each light, for scenes
+	 * of which the geometry and lights do not change between renders.
+	 *
+	 * The cache hashes a grid of cells over the bounds of the scene. Each
+	 * entry holds the visibility of a light computed at a point in a cell,
+	 * separately for each of the six major orientations of the surface, so
+	 * that both sides of a thin wall never share an entry. A lookup
+	 * bilinearly interpolates the cached entries among the four cells around
+	 * the point in the plane of the surface. The lookup misses if fewer than
+	 * two of these cells are cached or if their entries differ by more than
+	 * {@link VisibilityCache::tolerance}, so the edges of shadows are
+	 * computed with shadow rays.
+	 *
+	 * The cache can be shared by all threads of a render job.
+	 */
+	class VisibilityCache {
+	public:
+		/**
+		 * The amount of cells along the longest axis of the scene.
+		 */
+		const int resolution;
+
+		/**
+		 * The maximum difference between the visibility of the cells that
+		 * a lookup interpolates.
+		 */
+		const float tolerance;
+
+		/**
+		 * Construct a {@link VisibilityCache} instance.
+		 *
+		 * @param[in] resolution The amount of cells along the longest axis
+		 * of the scene.
+		 * @param[in] tolerance The maximum difference between interpolated
+		 * cells.
+		 * @param[in] capacity The amount of entries of the cache, which is
+		 * rounded up to a power of two.
+		 */
+		VisibilityCache(int = 256, float = 0.05f, size_t = 1 << 21);
+
+		/**
+		 * Prepare the cache for rendering the given scene. The cached
+		 * visibility is discarded if the generation or the lights of the
+		 * scene differ from the previous render.
+		 *
+		 * @param[in] scene The scene that is about to be rendered.
+		 */
+		void attach(const traceur::Scene &);
+
+		/**
+		 * Discard all cached visibility.
+		 */
+		void clear();
+
+		/**
+		 * Look up the visible fraction of a light at a point.
+		 *
+		 * @param[in] position The position of the point.
+		 * @param[in] normal The normal of the surface at the point.
+		 * @param[in] light The index of the light in the scene.
+		 * @param[out] visibility The interpolated visibility of the light.
+		 * @return <code>true</code> if the visibility could be
+		 * interpolated, otherwise <code>false</code>.
+		 */
+		bool lookup(const glm::vec3 &, const glm::vec3 &, size_t, float &) const;
+
+		/**
+		 * Store the visible fraction of a light at a point.
+		 *
+		 * @param[in] position The position of the point.
+		 * @param[in] normal The normal of the surface at the point.
+		 * @param[in] light The index of the light in the scene.
+		 * @param[in] visibility The visibility of the light.
+		 */
+		void store(const glm::vec3 &, const glm::vec3 &, size_t, float);
+	private:
+		/**
+		 * The entries of the cache, which pack the tag of a key above the
+		 * visibility quantized to 16 bits, or zero if the entry is empty.
+		 */
+		std::unique_ptr<std::atomic<uint64_t>[]> entries;
+
+		/**
+		 * The mask that maps a hash to an entry.
+		 */
+		size_t mask;
+
+		/**
+		 * The minimum corner of the grid.
+		 */
+		glm::vec3 origin;
+
+		/**
+		 * The size of a cell of the grid.
+		 */
+		float cellSize;
+
+		/**
+		 * The generation of the scene the cache was filled for, or zero if
+		 * the cache has not been attached to a scene.
+		 */
+		uint64_t generation;
+
+		/**
+		 * The lights of the scene the cache was filled for.
+		 */
+		std::vector<traceur::Light> lights;
+
+		/**
+		 * A mutex that serialises the preparation of the cache.
+		 */
+		std::mutex mutex;
+
+		/**
+		 * Find the entry of the given hash.
+		 *
+		 * @param[in] hash The hash of the key.
+		 * @param[out] visibility The visibility stored in the entry.
+		 * @return <code>true</code> if the key is cached, otherwise
+		 * <code>false</code>.
+		 */
+		bool find(uint64_t, float &) const;
+	};
+}
+
+#endif /* TRACEUR_CORE_LIGHTNING_CACHE_H */
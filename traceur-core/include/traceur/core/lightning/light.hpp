@@ -24,7 +24,7 @@
 #ifndef TRACEUR_CORE_LIGHTNING_LIGHT_H
 #define TRACEUR_CORE_LIGHTNING_LIGHT_H
 
-#include <traceur/core/scene/scene.hpp>
+#include <glm/glm.hpp>
 
 namespace traceur {
 	/**
@@ -0,0 +1,162 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_LIGHTNING_PHOTON_H
+#define TRACEUR_CORE_LIGHTNING_PHOTON_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+namespace traceur {
+	/**
+	 * A photon that has been deposited on a surface of a {@link Scene}.
+	 */
+	struct Photon {
+		/**
+		 * The position at which the photon was deposited.
+		 */
+		glm::vec3 position;
+
+		/**
+		 * The power the photon carries.
+		 */
+		glm::vec3 power;
+
+		/**
+		 * The direction in which the photon travelled.
+		 */
+		glm::vec3 direction;
+
+		/**
+		 * The axis of the plane that splits the photons of the subtree of
+		 * this photon in a {@link PhotonMap}.
+		 */
+		int axis;
+	};
+
+	/**
+	 * A balanced kd-tree over a set of photons.
+	 *
+	 * The tree is stored implicitly in a single array: the photon at the
+	 * middle of a range is the median of the range along its axis and
+	 * splits the range into its left and right subtree. The tree therefore
+	 * takes no space besides the photons and its subtrees lie contiguous in
+	 * memory.
+	 */
+	class PhotonMap {
+	public:
+		/**
+		 * The maximum amount of photons that a radiance estimate gathers.
+		 */
+		static constexpr int MaximumNeighbours = 256;
+
+		/**
+		 * The amount of photons that a radiance estimate gathers.
+		 */
+		int neighbours;
+
+		/**
+		 * The maximum distance of a gathered photon to the estimated point.
+		 */
+		float radius;
+
+		/**
+		 * Construct an empty {@link PhotonMap} instance.
+		 */
+		PhotonMap() : neighbours(0), radius(0) {}
+
+		/**
+		 * Construct a {@link PhotonMap} instance.
+		 *
+		 * @param[in] photons The photons to build the tree over.
+		 * @param[in] neighbours The amount of photons that a radiance
+		 * estimate gathers.
+		 * @param[in] radius The maximum distance of a gathered photon.
+		 */
+		PhotonMap(std::vector<traceur::Photon>, int, float);
+
+		/**
+		 * Find the photons nearest to a point.
+		 *
+		 * @param[in] position The position of the point.
+		 * @param[in] k The amount of photons to find, up to
+		 * {@link PhotonMap::MaximumNeighbours}.
+		 * @param[in] maxDistance The maximum distance of a photon to the
+		 * point.
+		 * @param[out] nearest The photons that have been found, which must
+		 * have room for <code>k</code> photons.
+		 * @param[out] distance2 The squared distance to the farthest photon
+		 * that has been found, or the squared maximum distance if less than
+		 * <code>k</code> photons lie within the maximum distance.
+		 * @return The amount of photons that have been found.
+		 */
+		int nearest(const glm::vec3 &, int, float, const traceur::Photon **, float &) const;
+
+		/**
+		 * Estimate the irradiance at a point on a surface from the photons
+		 * nearest to it that arrived at the front of the surface.
+		 *
+		 * @param[in] position The position of the point.
+		 * @param[in] normal The normal of the surface at the point.
+		 * @return The estimated irradiance.
+		 */
+		glm::vec3 irradiance(const glm::vec3 &, const glm::vec3 &) const;
+
+		/**
+		 * Return the amount of photons in the map.
+		 *
+		 * @return The amount of photons.
+		 */
+		inline size_t size() const
+		{
+			return photons.size();
+		}
+
+		/**
+		 * Determine whether the map contains no photons.
+		 *
+		 * @return <code>true</code> if the map is empty, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool empty() const
+		{
+			return photons.empty();
+		}
+	private:
+		/**
+		 * The photons of the map in the order of the tree.
+		 */
+		std::vector<traceur::Photon> photons;
+
+		/**
+		 * Build the subtree of a range of photons.
+		 *
+		 * @param[in] begin The index of the first photon of the range.
+		 * @param[in] end The index past the last photon of the range.
+		 */
+		void build(size_t, size_t);
+	};
+}
+
+#endif /* TRACEUR_CORE_LIGHTNING_PHOTON_H */
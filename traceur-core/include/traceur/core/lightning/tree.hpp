@@ -0,0 +1,161 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_LIGHTNING_TREE_H
+#define TRACEUR_CORE_LIGHTNING_TREE_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include <traceur/core/lightning/light.hpp>
+
+namespace traceur {
+	/**
+	 * A node in a {@link LightTree}, which bounds a cluster of lights.
+	 */
+	struct LightTreeNode {
+		/**
+		 * The minimum corner of the bounds of the cluster.
+		 */
+		glm::vec3 min;
+
+		/**
+		 * The maximum corner of the bounds of the cluster.
+		 */
+		glm::vec3 max;
+
+		/**
+		 * The amount of lights in the cluster.
+		 */
+		int count;
+
+		/**
+		 * The index of the light in the scene if this node is a leaf, or
+		 * <code>-1</code> otherwise.
+		 */
+		int light;
+
+		/**
+		 * The index of the right child of this node. The left child directly
+		 * follows its parent.
+		 */
+		int right;
+	};
+
+	/**
+	 * A bounding volume hierarchy over the lights of a {@link Scene}, which
+	 * is used to importance sample a light per shading point in time
+	 * logarithmic in the amount of lights.
+	 *
+	 * The importance of a cluster is the amount of lights in the cluster
+	 * times an upper bound of their contribution to the shading point: the
+	 * diffuse weight scaled by the largest cosine between the normal and the
+	 * bounds of the cluster, plus the specular weight. Every light that can
+	 * contribute to the shading point therefore has a non-zero probability,
+	 * which keeps the estimate unbiased.
+	 */
+	class LightTree {
+	public:
+		/**
+		 * Construct an empty {@link LightTree} instance.
+		 */
+		LightTree() {}
+
+		/**
+		 * Construct a {@link LightTree} instance.
+		 *
+		 * @param[in] lights The lights to build the tree over.
+		 */
+		LightTree(const std::vector<traceur::Light> &);
+
+		/**
+		 * Determine whether this tree contains no lights.
+		 *
+		 * @return <code>true</code> if the tree is empty, <code>false</code>
+		 * otherwise.
+		 */
+		inline bool empty() const
+		{
+			return nodes.empty();
+		}
+
+		/**
+		 * Sample a light proportional to its estimated contribution to the
+		 * given shading point.
+		 *
+		 * @param[in] position The position of the shading point.
+		 * @param[in] normal The normal at the shading point.
+		 * @param[in] diffuse The weight of the diffuse contribution.
+		 * @param[in] specular The weight of the specular contribution, which
+		 * does not depend on the direction of the light.
+		 * @param[in] u A uniform sample in the range [0, 1).
+		 * @param[out] pdf The probability of the sampled light.
+		 * @return The index of the sampled light in the scene, or
+		 * <code>-1</code> if no light can contribute to the shading point.
+		 */
+		int sample(const glm::vec3 &,
+				   const glm::vec3 &,
+				   float,
+				   float,
+				   float,
+				   float &) const;
+	private:
+		/**
+		 * The nodes of the tree in depth-first order.
+		 */
+		std::vector<traceur::LightTreeNode> nodes;
+
+		/**
+		 * Build the subtree over the given range of lights.
+		 *
+		 * @param[in] lights The lights of the scene.
+		 * @param[in] indices The indices of the lights to partition.
+		 * @param[in] begin The start of the range of indices.
+		 * @param[in] end The end of the range of indices.
+		 * @return The index of the root node of the subtree.
+		 */
+		int build(const std::vector<traceur::Light> &,
+				  std::vector<int> &,
+				  int,
+				  int);
+
+		/**
+		 * Return the importance of a node for the given shading point.
+		 *
+		 * @param[in] node The node to compute the importance of.
+		 * @param[in] position The position of the shading point.
+		 * @param[in] normal The normal at the shading point.
+		 * @param[in] diffuse The weight of the diffuse contribution.
+		 * @param[in] specular The weight of the specular contribution.
+		 * @return The importance of the node.
+		 */
+		float importance(const traceur::LightTreeNode &,
+						 const glm::vec3 &,
+						 const glm::vec3 &,
+						 float,
+						 float) const;
+	};
+}
+
+#endif /* TRACEUR_CORE_LIGHTNING_TREE_H */
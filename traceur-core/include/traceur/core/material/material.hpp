@@ -38,6 +38,12 @@ namespace traceur {
 		 */
 		glm::vec3 diffuse, ambient, specular, transmissionFilter;
 
+		/**
+		 * The radiance the material emits, which is zero for materials that
+		 * do not emit light.
+		 */
+		glm::vec3 emission;
+
 		/**
 		 * The specular exponent of the material.
 		 */
@@ -61,7 +67,7 @@ namespace traceur {
 		/**
 		 * Construct a {@link Material} instance.
 		 */
-		Material() : shininess(0.f), opticalDensity(1.f), transparency(0.f), illuminationModel(1) {}
+		Material() : emission(0.f), shininess(0.f), opticalDensity(1.f), transparency(0.f), illuminationModel(1) {}
 
 		/**
 		 * Construct a {@link Material} instance.
@@ -88,6 +94,7 @@ namespace traceur {
 			ambient(ambient),
 			specular(specular),
             transmissionFilter(transmissionFilter),
+            emission(0.f),
             shininess(shininess),
 			opticalDensity(optical_density),
             transparency(transparency),
@@ -0,0 +1,199 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_MATH_ISA_H
+#define TRACEUR_CORE_MATH_ISA_H
+
+#include <string>
+
+/*
+ * The attributes with which the variants of a SIMD kernel are compiled for
+ * an instruction set. The variants are flattened, so the inline functions
+ * they call are compiled for the same instruction set, while out-of-line
+ * copies of these functions remain safe to run on any processor.
+ */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define TRACEUR_ISA_DISPATCH 1
+#define TRACEUR_TARGET_SSE42 __attribute__((target("sse4.2,popcnt"), flatten))
+#define TRACEUR_TARGET_AVX2 __attribute__((target("avx2,fma"), flatten))
+#define TRACEUR_TARGET_AVX512 __attribute__((target("avx512f,avx512vl,avx512bw,avx512dq,avx2,fma"), flatten))
+#endif
+
+namespace traceur {
+	/**
+	 * An instruction set for which the SIMD kernels of the library are
+	 * built, in order of preference.
+	 */
+	enum class ISA: int {
+		/**
+		 * The instruction set the library is compiled for.
+		 */
+		Baseline = 0,
+
+		/**
+		 * SSE up to version 4.2.
+		 */
+		SSE42 = 1,
+
+		/**
+		 * AVX2 with fused multiply-add.
+		 */
+		AVX2 = 2,
+
+		/**
+		 * The AVX-512 foundation, vector length, byte/word and
+		 * doubleword/quadword extensions.
+		 */
+		AVX512 = 3
+	};
+
+	/**
+	 * Determine the best instruction set supported by the processor and
+	 * operating system this program runs on.
+	 *
+	 * @return The best supported instruction set.
+	 */
+	traceur::ISA detect_isa();
+
+	/**
+	 * Return the instruction set of which the kernels are used, which is the
+	 * best supported instruction set unless another has been forced.
+	 *
+	 * @return The active instruction set.
+	 */
+	traceur::ISA active_isa();
+
+	/**
+	 * Force the kernels to use the given instruction set, for instance to
+	 * compare the variants of the kernels. The variants are selected when a
+	 * render job or a batch of queries starts, so the instruction set must
+	 * be selected before then.
+	 *
+	 * @param[in] isa The instruction set to use.
+	 * @return <code>true</code> if the instruction set is supported,
+	 * otherwise <code>false</code> and the active instruction set is kept.
+	 */
+	bool force_isa(traceur::ISA);
+
+	/**
+	 * Return the name of the given instruction set.
+	 *
+	 * @param[in] isa The instruction set.
+	 * @return The name of the instruction set.
+	 */
+	const char * isa_name(traceur::ISA);
+
+	/**
+	 * Parse the name of an instruction set.
+	 *
+	 * @param[in] name The name of the instruction set.
+	 * @param[out] isa The parsed instruction set.
+	 * @return <code>true</code> if the name is known, otherwise
+	 * <code>false</code>.
+	 */
+	bool parse_isa(const std::string &, traceur::ISA &);
+
+	/**
+	 * Select the variant of a kernel for the active instruction set.
+	 *
+	 * @param[in] baseline The variant for the baseline instruction set.
+	 * @param[in] sse42 The variant for SSE 4.2.
+	 * @param[in] avx2 The variant for AVX2.
+	 * @param[in] avx512 The variant for AVX-512.
+	 * @return The variant to use.
+	 */
+	template<typename Function>
+	inline Function dispatch(Function baseline, Function sse42, Function avx2, Function avx512)
+	{
+		switch (traceur::active_isa()) {
+			case traceur::ISA::AVX512:
+				return avx512;
+			case traceur::ISA::AVX2:
+				return avx2;
+			case traceur::ISA::SSE42:
+				return sse42;
+			default:
+				return baseline;
+		}
+	}
+
+	/**
+	 * The code generation of an instruction set, with which a function object
+	 * is invoked. The invocation is flattened, so the function object and
+	 * every inline function it calls are compiled for the instruction set.
+	 * Calls through pointers, such as virtual methods, are not affected.
+	 *
+	 * @tparam I The instruction set to compile for.
+	 */
+	template<traceur::ISA I>
+	struct Target;
+
+	template<>
+	struct Target<traceur::ISA::Baseline> {
+		/**
+		 * Invoke a function object compiled for the instruction set.
+		 *
+		 * @param[in] function The function object to invoke.
+		 * @return The result of the function object.
+		 */
+		template<class Function>
+		static inline auto invoke(const Function &function) -> decltype(function())
+		{
+			return function();
+		}
+	};
+
+#ifdef TRACEUR_ISA_DISPATCH
+	template<>
+	struct Target<traceur::ISA::SSE42> {
+		template<class Function>
+		TRACEUR_TARGET_SSE42
+		static auto invoke(const Function &function) -> decltype(function())
+		{
+			return function();
+		}
+	};
+
+	template<>
+	struct Target<traceur::ISA::AVX2> {
+		template<class Function>
+		TRACEUR_TARGET_AVX2
+		static auto invoke(const Function &function) -> decltype(function())
+		{
+			return function();
+		}
+	};
+
+	template<>
+	struct Target<traceur::ISA::AVX512> {
+		template<class Function>
+		TRACEUR_TARGET_AVX512
+		static auto invoke(const Function &function) -> decltype(function())
+		{
+			return function();
+		}
+	};
+#endif
+}
+
+#endif /* TRACEUR_CORE_MATH_ISA_H */
@@ -0,0 +1,397 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_MATH_SIMD_H
+#define TRACEUR_CORE_MATH_SIMD_H
+
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRACEUR_SIMD_SSE2 1
+#endif
+
+#include <glm/glm.hpp>
+
+#include <traceur/core/kernel/ray.hpp>
+#include <traceur/core/scene/aabb.hpp>
+
+namespace traceur {
+	/**
+	 * A vector of four floats aligned to 16 bytes, which maps onto a single
+	 * SSE register where available.
+	 *
+	 * This type is internal to the traversal and intersection hot paths; the
+	 * public scene API keeps using <code>glm::vec3</code>.
+	 */
+	class alignas(16) Float4 {
+	public:
+#ifdef TRACEUR_SIMD_SSE2
+		/**
+		 * The lanes of the vector.
+		 */
+		__m128 value;
+
+		/**
+		 * Construct a {@link Float4} instance from a register.
+		 *
+		 * @param[in] value The register to wrap.
+		 */
+		Float4(__m128 value) : value(value) {}
+#else
+		/**
+		 * The lanes of the vector.
+		 */
+		float value[4];
+#endif
+
+		/**
+		 * Construct an uninitialized {@link Float4} instance.
+		 */
+		Float4() {}
+
+		/**
+		 * Construct a {@link Float4} instance.
+		 *
+		 * @param[in] x The first lane.
+		 * @param[in] y The second lane.
+		 * @param[in] z The third lane.
+		 * @param[in] w The fourth lane.
+		 */
+		Float4(float x, float y, float z, float w)
+		{
+#ifdef TRACEUR_SIMD_SSE2
+			value = _mm_setr_ps(x, y, z, w);
+#else
+			value[0] = x;
+			value[1] = y;
+			value[2] = z;
+			value[3] = w;
+#endif
+		}
+
+		/**
+		 * Construct a {@link Float4} instance from a vector and a fourth
+		 * lane.
+		 *
+		 * @param[in] v The first three lanes.
+		 * @param[in] w The fourth lane.
+		 */
+		Float4(const glm::vec3 &v, float w) : Float4(v.x, v.y, v.z, w) {}
+
+		/**
+		 * Construct a {@link Float4} instance of which all lanes have the
+		 * given value.
+		 *
+		 * @param[in] s The value of the lanes.
+		 * @return The vector.
+		 */
+		static inline Float4 broadcast(float s)
+		{
+			return Float4(s, s, s, s);
+		}
+
+		/**
+		 * Return the given lane of this vector.
+		 *
+		 * @param[in] i The index of the lane.
+		 * @return The value of the lane.
+		 */
+		inline float operator[](int i) const
+		{
+#ifdef TRACEUR_SIMD_SSE2
+			alignas(16) float lanes[4];
+			_mm_store_ps(lanes, value);
+			return lanes[i];
+#else
+			return value[i];
+#endif
+		}
+
+		/**
+		 * Return the smallest lane of this vector, ignoring lanes that are
+		 * not a number like <code>std::fmin</code>.
+		 *
+		 * @return The smallest lane.
+		 */
+		inline float minimum() const;
+
+		/**
+		 * Return the largest lane of this vector, ignoring lanes that are
+		 * not a number like <code>std::fmax</code>.
+		 *
+		 * @return The largest lane.
+		 */
+		inline float maximum() const;
+	};
+
+	/* Lane-wise arithmetic */
+#ifdef TRACEUR_SIMD_SSE2
+	inline traceur::Float4 operator+(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return _mm_add_ps(a.value, b.value);
+	}
+
+	inline traceur::Float4 operator-(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return _mm_sub_ps(a.value, b.value);
+	}
+
+	inline traceur::Float4 operator*(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return _mm_mul_ps(a.value, b.value);
+	}
+
+	inline traceur::Float4 operator/(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return _mm_div_ps(a.value, b.value);
+	}
+
+	inline traceur::Float4 operator-(const traceur::Float4 &a)
+	{
+		return _mm_xor_ps(a.value, _mm_set1_ps(-0.f));
+	}
+
+	/**
+	 * Return the lane-wise minimum of two vectors, which ignores lanes that
+	 * are not a number like <code>std::fmin</code>.
+	 */
+	inline traceur::Float4 fmin(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		/* _mm_min_ps returns its second operand if either is not a number */
+		__m128 nan = _mm_cmpunord_ps(b.value, b.value);
+		return _mm_or_ps(_mm_and_ps(nan, a.value), _mm_andnot_ps(nan, _mm_min_ps(a.value, b.value)));
+	}
+
+	/**
+	 * Return the lane-wise maximum of two vectors, which ignores lanes that
+	 * are not a number like <code>std::fmax</code>.
+	 */
+	inline traceur::Float4 fmax(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		__m128 nan = _mm_cmpunord_ps(b.value, b.value);
+		return _mm_or_ps(_mm_and_ps(nan, a.value), _mm_andnot_ps(nan, _mm_max_ps(a.value, b.value)));
+	}
+
+	/**
+	 * Return a bit mask of the lanes in which <code>a >= b</code>.
+	 */
+	inline int greaterEqual(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return _mm_movemask_ps(_mm_cmpge_ps(a.value, b.value));
+	}
+
+	/**
+	 * Return a bit mask of the lanes in which <code>a <= b</code>.
+	 */
+	inline int lessEqual(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return _mm_movemask_ps(_mm_cmple_ps(a.value, b.value));
+	}
+
+	inline float traceur::Float4::minimum() const
+	{
+		traceur::Float4 m = fmin(*this, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+		m = fmin(m, _mm_shuffle_ps(m.value, m.value, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(m.value);
+	}
+
+	inline float traceur::Float4::maximum() const
+	{
+		traceur::Float4 m = fmax(*this, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+		m = fmax(m, _mm_shuffle_ps(m.value, m.value, _MM_SHUFFLE(2, 3, 0, 1)));
+		return _mm_cvtss_f32(m.value);
+	}
+#else
+	/* Lane-wise arithmetic */
+	inline traceur::Float4 operator+(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return traceur::Float4(a.value[0] + b.value[0], a.value[1] + b.value[1],
+							   a.value[2] + b.value[2], a.value[3] + b.value[3]);
+	}
+
+	inline traceur::Float4 operator-(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return traceur::Float4(a.value[0] - b.value[0], a.value[1] - b.value[1],
+							   a.value[2] - b.value[2], a.value[3] - b.value[3]);
+	}
+
+	inline traceur::Float4 operator*(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return traceur::Float4(a.value[0] * b.value[0], a.value[1] * b.value[1],
+							   a.value[2] * b.value[2], a.value[3] * b.value[3]);
+	}
+
+	inline traceur::Float4 operator/(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return traceur::Float4(a.value[0] / b.value[0], a.value[1] / b.value[1],
+							   a.value[2] / b.value[2], a.value[3] / b.value[3]);
+	}
+
+	inline traceur::Float4 operator-(const traceur::Float4 &a)
+	{
+		return traceur::Float4(-a.value[0], -a.value[1], -a.value[2], -a.value[3]);
+	}
+
+	inline traceur::Float4 fmin(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return traceur::Float4(std::fmin(a.value[0], b.value[0]), std::fmin(a.value[1], b.value[1]),
+							   std::fmin(a.value[2], b.value[2]), std::fmin(a.value[3], b.value[3]));
+	}
+
+	inline traceur::Float4 fmax(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		return traceur::Float4(std::fmax(a.value[0], b.value[0]), std::fmax(a.value[1], b.value[1]),
+							   std::fmax(a.value[2], b.value[2]), std::fmax(a.value[3], b.value[3]));
+	}
+
+	inline int greaterEqual(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; i++) {
+			mask |= (a.value[i] >= b.value[i]) << i;
+		}
+		return mask;
+	}
+
+	inline int lessEqual(const traceur::Float4 &a, const traceur::Float4 &b)
+	{
+		int mask = 0;
+		for (int i = 0; i < 4; i++) {
+			mask |= (a.value[i] <= b.value[i]) << i;
+		}
+		return mask;
+	}
+
+	inline float traceur::Float4::minimum() const
+	{
+		return std::fmin(std::fmin(value[0], value[1]), std::fmin(value[2], value[3]));
+	}
+
+	inline float traceur::Float4::maximum() const
+	{
+		return std::fmax(std::fmax(value[0], value[1]), std::fmax(value[2], value[3]));
+	}
+#endif
+
+	/**
+	 * A {@link Ray} prepared for the traversal of a scene graph, of which the
+	 * inverse direction is computed once and the components are broadcast
+	 * for intersecting four primitives at a time.
+	 */
+	class AlignedRay {
+	public:
+		/**
+		 * The origin of the ray.
+		 */
+		traceur::Float4 origin;
+
+		/**
+		 * The inverse of the direction of the ray.
+		 */
+		traceur::Float4 inverse;
+
+		/**
+		 * The components of the origin of the ray, broadcast to all lanes.
+		 */
+		traceur::Float4 ox, oy, oz;
+
+		/**
+		 * The components of the direction of the ray, broadcast to all
+		 * lanes.
+		 */
+		traceur::Float4 dx, dy, dz;
+
+		/**
+		 * Construct an {@link AlignedRay} instance.
+		 *
+		 * @param[in] ray The ray to prepare.
+		 */
+		AlignedRay(const traceur::Ray &ray) :
+			origin(ray.origin, 0.f),
+			inverse(1.0f / ray.direction, 1.f),
+			ox(traceur::Float4::broadcast(ray.origin.x)),
+			oy(traceur::Float4::broadcast(ray.origin.y)),
+			oz(traceur::Float4::broadcast(ray.origin.z)),
+			dx(traceur::Float4::broadcast(ray.direction.x)),
+			dy(traceur::Float4::broadcast(ray.direction.y)),
+			dz(traceur::Float4::broadcast(ray.direction.z)) {}
+	};
+
+	/**
+	 * An {@link AABB} padded to two aligned vectors, which is intersected
+	 * with an {@link AlignedRay} using SIMD instructions.
+	 */
+	class AlignedBox {
+	public:
+		/**
+		 * The minimum vertex in the box.
+		 */
+		traceur::Float4 min;
+
+		/**
+		 * The maximum vertex in the box.
+		 */
+		traceur::Float4 max;
+
+		/**
+		 * Construct an {@link AlignedBox} instance.
+		 *
+		 * @param[in] box The bounding box to pad. The padding lanes span
+		 * the whole line, so they never reject a ray.
+		 */
+		AlignedBox(const traceur::AABB &box) :
+			min(box.min, -std::numeric_limits<float>::infinity()),
+			max(box.max, std::numeric_limits<float>::infinity()) {}
+
+		/**
+		 * Determine whether the given ray intersects this box.
+		 *
+		 * This method gives the same results as
+		 * {@link AABB#intersect(const Ray &, float &, float &)}.
+		 *
+		 * @param[in] ray The ray to intersect with this box.
+		 * @param[out] tmin The distance at which the ray enters the box.
+		 * @param[out] tmax The distance at which the ray leaves the box.
+		 * @return <code>true</code> if the box intersects the ray, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool intersect(const traceur::AlignedRay &ray, float &tmin, float &tmax) const
+		{
+			auto u = (min - ray.origin) * ray.inverse;
+			auto v = (max - ray.origin) * ray.inverse;
+
+			tmin = fmin(u, v).maximum();
+			tmax = fmax(u, v).minimum();
+
+			if (tmax < 0)
+				return false;
+			if (tmin > tmax)
+				return false;
+			return true;
+		}
+	};
+}
+
+#endif /* TRACEUR_CORE_MATH_SIMD_H */
@@ -0,0 +1,255 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_MEMORY_ARENA_H
+#define TRACEUR_CORE_MEMORY_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace traceur {
+	/**
+	 * A contiguous, fixed-size array of elements that have been placed into
+	 * an {@link Arena}, which owns the elements.
+	 */
+	template<typename T>
+	class ArenaArray {
+		/**
+		 * The first element of the array.
+		 */
+		T *first;
+
+		/**
+		 * The number of elements in the array.
+		 */
+		size_t count;
+	public:
+		/**
+		 * Construct an empty {@link ArenaArray} instance.
+		 */
+		ArenaArray() : first(nullptr), count(0) {}
+
+		/**
+		 * Construct an {@link ArenaArray} instance.
+		 *
+		 * @param[in] first The first element of the array.
+		 * @param[in] count The number of elements in the array.
+		 */
+		ArenaArray(T *first, size_t count) : first(first), count(count) {}
+
+		/**
+		 * Return an iterator to the first element of the array.
+		 *
+		 * @return A pointer to the first element.
+		 */
+		inline T * begin() const
+		{
+			return first;
+		}
+
+		/**
+		 * Return an iterator past the last element of the array.
+		 *
+		 * @return A pointer past the last element.
+		 */
+		inline T * end() const
+		{
+			return first + count;
+		}
+
+		/**
+		 * Return the number of elements in the array.
+		 *
+		 * @return The size of the array.
+		 */
+		inline size_t size() const
+		{
+			return count;
+		}
+
+		/**
+		 * Determine whether the array contains no elements.
+		 *
+		 * @return <code>true</code> if the array is empty, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool empty() const
+		{
+			return count == 0;
+		}
+
+		/**
+		 * Return the element at the given index.
+		 *
+		 * @param[in] index The index of the element.
+		 * @return A reference to the element.
+		 */
+		inline T & operator[](size_t index) const
+		{
+			return first[index];
+		}
+	};
+
+	/**
+	 * A monotonic memory arena, from which objects are allocated by bumping
+	 * a pointer into large blocks of memory. The memory is released all at
+	 * once when the arena is destructed, which keeps objects that are
+	 * created together close in memory and makes freeing them a matter of
+	 * unmapping a few blocks.
+	 *
+	 * The arena never runs the destructors of the objects placed into it,
+	 * so these objects must not own any resources outside the arena.
+	 * An arena is not thread-safe; it is meant to be filled by a single
+	 * thread while building a scene and only read afterwards.
+	 *
+	 * On Linux, the blocks can be backed by transparent huge pages by
+	 * compiling with <code>USE_HUGE_PAGES</code>, which reduces the TLB
+	 * misses of traversing large scenes.
+	 */
+	class Arena {
+		/**
+		 * A block of memory owned by the arena.
+		 */
+		struct Block {
+			/**
+			 * The start of the block.
+			 */
+			void *data;
+
+			/**
+			 * The size of the block in bytes.
+			 */
+			size_t size;
+		};
+
+		/**
+		 * The blocks owned by this arena.
+		 */
+		std::vector<Block> blocks;
+
+		/**
+		 * The next free byte in the current block.
+		 */
+		uintptr_t head;
+
+		/**
+		 * The end of the current block.
+		 */
+		uintptr_t tail;
+
+		/**
+		 * Allocate a new block from which the given allocation is served.
+		 *
+		 * @param[in] size The size of the allocation in bytes.
+		 * @param[in] alignment The alignment of the allocation.
+		 * @return A pointer to the allocated memory.
+		 */
+		void * grow(size_t, size_t);
+	public:
+		/**
+		 * The size of the blocks allocated by the arena, which equals the
+		 * size of a huge page on x86-64.
+		 */
+		static const size_t BlockSize = 2 << 20;
+
+		/**
+		 * Construct an empty {@link Arena} instance.
+		 */
+		Arena() : head(0), tail(0) {}
+
+		/**
+		 * Deconstruct the {@link Arena} instance, which releases all memory
+		 * allocated from it.
+		 */
+		~Arena();
+
+		Arena(const Arena &) = delete;
+		Arena & operator=(const Arena &) = delete;
+
+		/**
+		 * Allocate uninitialized memory from the arena.
+		 *
+		 * @param[in] size The size of the allocation in bytes.
+		 * @param[in] alignment The alignment of the allocation, which must
+		 * be a power of two.
+		 * @return A pointer to the allocated memory.
+		 */
+		inline void * allocate(size_t size, size_t alignment)
+		{
+			uintptr_t start = (head + alignment - 1) & ~(uintptr_t) (alignment - 1);
+
+			if (start + size > tail) {
+				return grow(size, alignment);
+			}
+
+			head = start + size;
+			return reinterpret_cast<void *>(start);
+		}
+
+		/**
+		 * Construct an object of type <code>T</code> in the arena.
+		 *
+		 * @param[in] args The arguments with which the object will be
+		 * constructed.
+		 * @return A pointer to the constructed object.
+		 */
+		template<typename T, typename... Args>
+		inline T * create(Args&&... args)
+		{
+			void *memory = allocate(sizeof(T), alignof(T));
+			return new (memory) T(std::forward<Args>(args)...);
+		}
+
+		/**
+		 * Copy the given elements into a contiguous array in the arena.
+		 *
+		 * @param[in] elements The elements to copy into the arena.
+		 * @return The {@link ArenaArray} containing the copies.
+		 */
+		template<typename T>
+		inline traceur::ArenaArray<T> array(const std::vector<T> &elements)
+		{
+			if (elements.empty()) {
+				return traceur::ArenaArray<T>();
+			}
+
+			T *first = static_cast<T *>(allocate(sizeof(T) * elements.size(), alignof(T)));
+			for (size_t i = 0; i < elements.size(); i++) {
+				new (first + i) T(elements[i]);
+			}
+			return traceur::ArenaArray<T>(first, elements.size());
+		}
+
+		/**
+		 * Return the amount of memory reserved by the arena.
+		 *
+		 * @return The size of all blocks of the arena in bytes.
+		 */
+		size_t capacity() const;
+	};
+}
+
+#endif /* TRACEUR_CORE_MEMORY_ARENA_H */
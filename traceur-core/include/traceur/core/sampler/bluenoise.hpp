@@ -0,0 +1,138 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SAMPLER_BLUENOISE_H
+#define TRACEUR_CORE_SAMPLER_BLUENOISE_H
+
+#include <vector>
+
+#include <traceur/core/sampler/sampler.hpp>
+
+namespace traceur {
+	/**
+	 * A tileable blue-noise mask, which assigns every texel of a square tile a
+	 * threshold in [0, 1) such that texels with similar thresholds are spread
+	 * out evenly over the tile.
+	 *
+	 * The tile is generated once with the void-and-cluster method (Ulichney,
+	 * 1993) on first use and shared by all samplers.
+	 */
+	class BlueNoiseTile {
+	public:
+		/**
+		 * The width and height of the tile.
+		 */
+		static const int size = 64;
+
+		/**
+		 * Return the shared instance of the tile.
+		 *
+		 * @return The blue-noise tile.
+		 */
+		static const BlueNoiseTile & instance();
+
+		/**
+		 * Return the threshold of the texel at the given position, wrapping
+		 * around the edges of the tile.
+		 *
+		 * @param[in] x The x coordinate of the texel.
+		 * @param[in] y The y coordinate of the texel.
+		 * @return The threshold in the range [0, 1).
+		 */
+		inline float operator()(int x, int y) const
+		{
+			return values[(y & (size - 1)) * size + (x & (size - 1))];
+		}
+	private:
+		/**
+		 * Construct and generate a {@link BlueNoiseTile} instance.
+		 */
+		BlueNoiseTile();
+
+		/**
+		 * The thresholds of the tile in row-major order.
+		 */
+		std::vector<float> values;
+	};
+
+	/**
+	 * A {@link Sampler} that uses the same sequence for every pixel and
+	 * rotates it per pixel by the value of a {@link BlueNoiseTile}. This
+	 * distributes the error between neighbouring pixels as blue noise, which
+	 * is perceived as less noisy than white noise of the same magnitude.
+	 */
+	class BlueNoiseSampler: public Sampler {
+	public:
+		/**
+		 * Construct a {@link BlueNoiseSampler} instance.
+		 *
+		 * @param[in] sampler The sampler to generate the sequence with.
+		 */
+		explicit BlueNoiseSampler(std::shared_ptr<traceur::Sampler> sampler) :
+			sampler(sampler), tile(traceur::BlueNoiseTile::instance()) {}
+
+		/**
+		 * Return a single component of a sample vector.
+		 *
+		 * @param[in] pixel The pixel the sample belongs to.
+		 * @param[in] index The index of the sample within the pixel.
+		 * @param[in] dimension The dimension of the sample vector.
+		 * @return The sample value in the range [0, 1).
+		 */
+		virtual float sample(const glm::ivec2 &, uint32_t, uint32_t) const final;
+
+		/**
+		 * Return the amount of consecutive dimensions of a sample vector
+		 * that are stratified together by the underlying sampler.
+		 *
+		 * @return The size of a block of dimensions.
+		 */
+		virtual uint32_t blockSize() const final
+		{
+			return sampler->blockSize();
+		}
+
+		/**
+		 * Return the name of this sampler.
+		 *
+		 * @return A string representing the name of this sampler.
+		 */
+		virtual const std::string & name() const final
+		{
+			static const std::string name = "bluenoise";
+			return name;
+		}
+	private:
+		/**
+		 * The sampler that generates the sequence.
+		 */
+		std::shared_ptr<traceur::Sampler> sampler;
+
+		/**
+		 * The blue-noise tile to rotate the samples with.
+		 */
+		const traceur::BlueNoiseTile &tile;
+	};
+}
+
+#endif /* TRACEUR_CORE_SAMPLER_BLUENOISE_H */
@@ -0,0 +1,65 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SAMPLER_HALTON_H
+#define TRACEUR_CORE_SAMPLER_HALTON_H
+
+#include <traceur/core/sampler/sampler.hpp>
+
+namespace traceur {
+	/**
+	 * A {@link Sampler} that generates the Halton sequence, which uses the
+	 * radical inverse in the n-th prime base for the n-th dimension.
+	 *
+	 * Each pixel uses a randomised (Cranley-Patterson rotated) copy of the
+	 * sequence so the error of neighbouring pixels is not correlated.
+	 * Dimensions beyond the supported bases are padded with copies of the
+	 * sequence in their base, of which the order of the points is shuffled
+	 * for every wrap, like the {@link SobolSampler} pads its dimensions.
+	 */
+	class HaltonSampler: public Sampler {
+	public:
+		/**
+		 * Return a single component of a sample vector.
+		 *
+		 * @param[in] pixel The pixel the sample belongs to.
+		 * @param[in] index The index of the sample within the pixel.
+		 * @param[in] dimension The dimension of the sample vector.
+		 * @return The sample value in the range [0, 1).
+		 */
+		virtual float sample(const glm::ivec2 &, uint32_t, uint32_t) const final;
+
+		/**
+		 * Return the name of this sampler.
+		 *
+		 * @return A string representing the name of this sampler.
+		 */
+		virtual const std::string & name() const final
+		{
+			static const std::string name = "halton";
+			return name;
+		}
+	};
+}
+
+#endif /* TRACEUR_CORE_SAMPLER_HALTON_H */
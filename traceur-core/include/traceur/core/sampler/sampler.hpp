@@ -0,0 +1,273 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SAMPLER_SAMPLER_H
+#define TRACEUR_CORE_SAMPLER_SAMPLER_H
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include <glm/glm.hpp>
+
+namespace traceur {
+	/**
+	 * The largest float value below one.
+	 */
+	const float oneMinusEpsilon = 0.99999994f;
+
+	/**
+	 * A {@link Sampler} generates the sample points a {@link Kernel} uses to
+	 * integrate over pixels and lights.
+	 *
+	 * A sample is addressed by the pixel it belongs to, its index within the
+	 * pixel and the dimension of the sample vector that is being consumed.
+	 * Implementations are stateless, so a single instance may be shared
+	 * between threads.
+	 */
+	class Sampler {
+	public:
+		/**
+		 * Deconstruct the {@link Sampler} instance.
+		 */
+		virtual ~Sampler() {}
+
+		/**
+		 * Return a single component of a sample vector.
+		 *
+		 * @param[in] pixel The pixel the sample belongs to.
+		 * @param[in] index The index of the sample within the pixel.
+		 * @param[in] dimension The dimension of the sample vector.
+		 * @return The sample value in the range [0, 1).
+		 */
+		virtual float sample(const glm::ivec2 &, uint32_t, uint32_t) const = 0;
+
+		/**
+		 * Return the amount of consecutive dimensions of a sample vector
+		 * that are stratified together by this sampler.
+		 *
+		 * @return The size of a block of dimensions.
+		 */
+		virtual uint32_t blockSize() const
+		{
+			return 1;
+		}
+
+		/**
+		 * Return the name of this sampler.
+		 *
+		 * @return A string representing the name of this sampler.
+		 */
+		virtual const std::string & name() const = 0;
+	};
+
+	/**
+	 * A stream of sample dimensions for a single pixel, which hands out the
+	 * dimensions of the sample vector to the consumers in a {@link Kernel} in
+	 * a deterministic order.
+	 */
+	class SampleStream {
+	public:
+		/**
+		 * Construct a {@link SampleStream} instance.
+		 *
+		 * @param[in] sampler The sampler to draw the samples from.
+		 */
+		explicit SampleStream(const traceur::Sampler &sampler) :
+			sampler(sampler), block(std::max(1u, sampler.blockSize())), pixel(0, 0), sample(0), dimension(0) {}
+
+		/**
+		 * Start the stream of a new sample of a pixel.
+		 *
+		 * @param[in] pixel The pixel to generate samples for.
+		 * @param[in] index The index of the sample within the pixel.
+		 */
+		inline void start(const glm::ivec2 &pixel, uint32_t index = 0)
+		{
+			this->pixel = pixel;
+			this->sample = index;
+			this->dimension = 0;
+		}
+
+		/**
+		 * Return the index of the current sample within the pixel.
+		 *
+		 * Consumers that take multiple samples of their dimensions per pixel
+		 * sample should use the indices <code>index() * n</code> up to
+		 * <code>(index() + 1) * n</code>.
+		 *
+		 * @return The index of the current sample.
+		 */
+		inline uint32_t index() const
+		{
+			return sample;
+		}
+
+		/**
+		 * Reserve a number of consecutive dimensions of the sample vector.
+		 *
+		 * The reserved dimensions start at a block of dimensions of the
+		 * sampler, so consecutive consumers do not share the stratification
+		 * of a block.
+		 *
+		 * @param[in] n The amount of dimensions to reserve.
+		 * @return The first dimension that has been reserved.
+		 */
+		inline uint32_t reserve(uint32_t n)
+		{
+			uint32_t first = (dimension + block - 1) / block * block;
+			dimension = first + n;
+			return first;
+		}
+
+		/**
+		 * Return a component of a sample vector of the current pixel.
+		 *
+		 * @param[in] index The index of the sample within the pixel.
+		 * @param[in] dimension The dimension of the sample vector.
+		 * @return The sample value in the range [0, 1).
+		 */
+		inline float operator()(uint32_t index, uint32_t dimension) const
+		{
+			return sampler.sample(pixel, index, dimension);
+		}
+	private:
+		/**
+		 * The sampler to draw the samples from.
+		 */
+		const traceur::Sampler &sampler;
+
+		/**
+		 * The amount of dimensions the sampler stratifies together.
+		 */
+		uint32_t block;
+
+		/**
+		 * The pixel that is being sampled.
+		 */
+		glm::ivec2 pixel;
+
+		/**
+		 * The index of the current sample within the pixel.
+		 */
+		uint32_t sample;
+
+		/**
+		 * The next free dimension of the sample vector.
+		 */
+		uint32_t dimension;
+	};
+
+	/**
+	 * Hash the given values into a well-distributed 32-bit integer.
+	 *
+	 * @param[in] a The first value to hash.
+	 * @param[in] b The second value to hash.
+	 * @return The hash of the values.
+	 */
+	inline uint32_t hash(uint32_t a, uint32_t b)
+	{
+		uint32_t h = a * 0x9e3779b9u ^ (b + 0x7f4a7c15u + (a << 6) + (a >> 2));
+		h ^= h >> 16;
+		h *= 0x7feb352du;
+		h ^= h >> 15;
+		h *= 0x846ca68bu;
+		h ^= h >> 16;
+		return h;
+	}
+
+	/**
+	 * Hash a pixel into a 32-bit seed.
+	 *
+	 * @param[in] pixel The pixel to hash.
+	 * @return The seed of the pixel.
+	 */
+	inline uint32_t hash(const glm::ivec2 &pixel)
+	{
+		return hash(static_cast<uint32_t>(pixel.x), static_cast<uint32_t>(pixel.y));
+	}
+
+	/**
+	 * Convert a 32-bit fixed point fraction into a float in the range
+	 * [0, 1).
+	 *
+	 * @param[in] x The fraction to convert.
+	 * @return The float value of the fraction.
+	 */
+	inline float fraction(uint32_t x)
+	{
+		/* Use the upper 24 bits so the result never rounds up to one */
+		return (x >> 8) * (1.f / 16777216.f);
+	}
+
+	/**
+	 * Reverse the bits of a 32-bit integer.
+	 *
+	 * @param[in] x The integer to reverse.
+	 * @return The reversed integer.
+	 */
+	inline uint32_t reverse_bits(uint32_t x)
+	{
+		x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+		x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+		x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+		x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+		return (x >> 16) | (x << 16);
+	}
+
+	/**
+	 * Apply a nested uniform (Owen) scramble to a 32-bit integer, using the
+	 * hash-based Laine-Karras permutation (Burley, 2020) on its reversed
+	 * bits. A bit of the result only depends on the same and the higher bits
+	 * of the input, so every aligned block of a power of two integers is
+	 * mapped onto an aligned block of the same size.
+	 *
+	 * @param[in] x The integer to scramble.
+	 * @param[in] seed The seed of the scramble.
+	 * @return The scrambled integer.
+	 */
+	inline uint32_t owen_scramble(uint32_t x, uint32_t seed)
+	{
+		x = traceur::reverse_bits(x);
+		x ^= x * 0x3d20adeau;
+		x += seed;
+		x *= (seed >> 16) | 1u;
+		x ^= x * 0x05526c56u;
+		x ^= x * 0x53a22864u;
+		return traceur::reverse_bits(x);
+	}
+
+	/**
+	 * Create a {@link Sampler} by its name.
+	 *
+	 * The supported names are <code>independent</code>, <code>halton</code>,
+	 * <code>sobol</code>, <code>owen</code> and <code>bluenoise</code>.
+	 *
+	 * @param[in] name The name of the sampler to create.
+	 * @return The sampler or <code>nullptr</code> if the name is unknown.
+	 */
+	std::shared_ptr<traceur::Sampler> make_sampler(const std::string &);
+}
+
+#endif /* TRACEUR_CORE_SAMPLER_SAMPLER_H */
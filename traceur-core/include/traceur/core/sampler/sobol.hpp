@@ -0,0 +1,97 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SAMPLER_SOBOL_H
+#define TRACEUR_CORE_SAMPLER_SOBOL_H
+
+#include <traceur/core/sampler/sampler.hpp>
+
+namespace traceur {
+	/**
+	 * A {@link Sampler} that generates the Sobol (0,2)-sequence in base 2.
+	 *
+	 * The sampler uses the first four dimensions of the sequence and pads
+	 * higher dimensions with independently shuffled copies of these, as
+	 * described in "Practical Hash-based Owen Scrambling" (Burley, 2020).
+	 * When scrambling is enabled, every pixel receives its own nested uniform
+	 * (Owen) scrambled copy of the sequence, which keeps the stratification of
+	 * the sequence while removing the correlation between pixels. Otherwise,
+	 * the copies are decorrelated by a random digital shift.
+	 */
+	class SobolSampler: public Sampler {
+	public:
+		/**
+		 * A flag to indicate that the sequence is Owen scrambled.
+		 */
+		const bool scrambled;
+
+		/**
+		 * Construct a {@link SobolSampler} instance.
+		 *
+		 * @param[in] scrambled A flag to enable Owen scrambling.
+		 */
+		explicit SobolSampler(bool scrambled = true) : scrambled(scrambled) {}
+
+		/**
+		 * Return a single component of a sample vector.
+		 *
+		 * @param[in] pixel The pixel the sample belongs to.
+		 * @param[in] index The index of the sample within the pixel.
+		 * @param[in] dimension The dimension of the sample vector.
+		 * @return The sample value in the range [0, 1).
+		 */
+		virtual float sample(const glm::ivec2 &, uint32_t, uint32_t) const final;
+
+		/**
+		 * Return the amount of consecutive dimensions of a sample vector
+		 * that are stratified together, which is the amount of dimensions
+		 * of the sequence that pad the higher dimensions.
+		 *
+		 * @return The size of a block of dimensions.
+		 */
+		virtual uint32_t blockSize() const final;
+
+		/**
+		 * Return the name of this sampler.
+		 *
+		 * @return A string representing the name of this sampler.
+		 */
+		virtual const std::string & name() const final
+		{
+			static const std::string sobol = "sobol";
+			static const std::string owen = "owen";
+			return scrambled ? owen : sobol;
+		}
+
+		/**
+		 * Return a component of the unscrambled Sobol sequence.
+		 *
+		 * @param[in] index The index of the sample in the sequence.
+		 * @param[in] dimension The dimension in the range [0, 4).
+		 * @return The sample as 32-bit fixed point fraction.
+		 */
+		static uint32_t sobol(uint32_t, uint32_t);
+	};
+}
+
+#endif /* TRACEUR_CORE_SAMPLER_SOBOL_H */
@@ -0,0 +1,164 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#ifndef TRACEUR_CORE_SCENE_AABB_H
+#define TRACEUR_CORE_SCENE_AABB_H
+
+#include <cmath>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+#include <traceur/core/kernel/ray.hpp>
+
+namespace traceur {
+	/**
+	 * An axis-aligned bounding box, which encapsulates the geometry of a
+	 * {@link Node} in the scene graph.
+	 *
+	 * Unlike a {@link Box} primitive, a bounding box has no material, so it
+	 * can be copied and expanded freely while building a scene graph.
+	 */
+	class AABB {
+	public:
+		/**
+		 * An axis of the box.
+		 */
+		enum class Axis: int {
+			X = 0, Y = 1, Z = 2
+		};
+
+		/**
+		 * The minimum vertex in the box.
+		 */
+		glm::vec3 min;
+
+		/**
+		 * The maximum vertex in the box.
+		 */
+		glm::vec3 max;
+
+		/**
+		 * Construct an {@link AABB} instance at the origin.
+		 */
+		AABB() : min(glm::vec3()), max(glm::vec3()) {}
+
+		/**
+		 * Construct an {@link AABB} instance.
+		 *
+		 * @param[in] min The minimum vertex in the box.
+		 * @param[in] max The maximum vertex in the box.
+		 */
+		AABB(const glm::vec3 &min, const glm::vec3 &max) : min(min), max(max) {}
+
+		/**
+		 * Construct an empty {@link AABB}, which contains nothing and can be
+		 * expanded with other boxes.
+		 *
+		 * @return The empty bounding box.
+		 */
+		static AABB empty()
+		{
+			auto min = glm::vec3(std::numeric_limits<float>::infinity());
+			return AABB(min, -min);
+		}
+
+		/**
+		 * Determine whether the given ray intersects this box.
+		 *
+		 * @param[in] ray The ray to intersect with this box.
+		 * @param[out] tmin The distance at which the ray enters the box.
+		 * @param[out] tmax The distance at which the ray leaves the box.
+		 * @return <code>true</code> if the box intersects the ray, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool intersect(const traceur::Ray &ray, float &tmin, float &tmax) const
+		{
+			/* TODO precalculate inverse */
+			glm::vec3 inverse = 1.0f / ray.direction;
+			auto u = (min - ray.origin) * inverse;
+			auto v = (max - ray.origin) * inverse;
+
+			tmin = std::fmax(std::fmax(std::fmin(u[0], v[0]), std::fmin(u[1], v[1])), std::fmin(u[2], v[2]));
+			tmax = std::fmin(std::fmin(std::fmax(u[0], v[0]), std::fmax(u[1], v[1])), std::fmax(u[2], v[2]));
+
+			if (tmax < 0)
+				return false;
+			if (tmin > tmax)
+				return false;
+			return true;
+		}
+
+		/**
+		 * Determine whether the given ray intersects this box.
+		 *
+		 * @param[in] ray The ray to intersect with this box.
+		 * @return <code>true</code> if the box intersects the ray, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool intersects(const traceur::Ray &ray) const
+		{
+			float tmin, tmax;
+			return intersect(ray, tmin, tmax);
+		}
+
+		/**
+		 * Expand this box with another box.
+		 *
+		 * @param[in] other The other box to expand with.
+		 * @return The expanded box.
+		 */
+		inline traceur::AABB expand(const traceur::AABB &other) const
+		{
+			return traceur::AABB(glm::min(min, other.min), glm::max(max, other.max));
+		}
+
+		/**
+		 * Return the center of this box.
+		 *
+		 * @return The center of the box.
+		 */
+		inline glm::vec3 center() const
+		{
+			return (min + max) / 2.f;
+		}
+
+		/**
+		 * Return the longest axis of this box.
+		 *
+		 * @return The longest axis of the box.
+		 */
+		inline traceur::AABB::Axis longestAxis() const
+		{
+			auto length = max - min;
+			if (length.x > length.y && length.x > length.z)
+				return traceur::AABB::Axis::X;
+			if (length.y > length.x && length.y > length.z)
+				return traceur::AABB::Axis::Y;
+			return traceur::AABB::Axis::Z;
+		}
+	};
+}
+
+#endif /* TRACEUR_CORE_SCENE_AABB_H */
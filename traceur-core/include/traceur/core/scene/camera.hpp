@@ -61,6 +61,9 @@ namespace traceur {
 		 * Create a {@link Ray} instance for the given window coordinates
 		 * (x, y).
 		 *
+		 * This method inverts the view-projection matrix for every ray; use a
+		 * {@link RayGenerator} to create many rays for the same camera.
+		 *
 		 * @param[in] win The window coordinates to create a ray for.
 		 */
 		traceur::Ray rayFrom(const glm::vec2 &win) const noexcept
@@ -206,6 +209,105 @@ namespace traceur {
 		 */
 		glm::mat4 m_projection;
 	};
+
+	/**
+	 * A generator of the primary rays of a {@link Camera}, which inverts the
+	 * view-projection matrix of the camera only once.
+	 *
+	 * The points on the near and far planes that correspond to window
+	 * coordinates are affine in these coordinates before the perspective
+	 * division, so they are derived from the points at the origin of the
+	 * window and their steps per pixel.
+	 */
+	class RayGenerator {
+		/**
+		 * The homogeneous point on the near plane at the window origin.
+		 */
+		glm::vec4 nearPoint;
+
+		/**
+		 * The homogeneous point on the far plane at the window origin.
+		 */
+		glm::vec4 farPoint;
+
+		/**
+		 * The step of the homogeneous points per pixel in x-direction.
+		 */
+		glm::vec4 dx;
+
+		/**
+		 * The step of the homogeneous points per pixel in y-direction.
+		 */
+		glm::vec4 dy;
+	public:
+		/**
+		 * Construct a {@link RayGenerator} instance.
+		 *
+		 * @param[in] camera The camera to generate the rays of.
+		 */
+		explicit RayGenerator(const traceur::Camera &camera) noexcept
+		{
+			auto inverse = glm::inverse(camera.projection() * camera.view());
+			auto &viewport = camera.viewport;
+
+			/* The normalized device coordinates at the window origin, like
+			 * glm::unProject with depth in [-1, 1] */
+			float x = -2.f * viewport[0] / viewport[2] - 1.f;
+			float y = -2.f * viewport[1] / viewport[3] - 1.f;
+
+			nearPoint = inverse * glm::vec4(x, y, -1.f, 1.f);
+			farPoint = inverse * glm::vec4(x, y, 1.f, 1.f);
+			dx = inverse[0] * (2.f / viewport[2]);
+			dy = inverse[1] * (2.f / viewport[3]);
+		}
+
+		/**
+		 * Create a {@link Ray} instance for the given window coordinates
+		 * (x, y).
+		 *
+		 * @param[in] win The window coordinates to create a ray for.
+		 * @return The ray through the given window coordinates.
+		 */
+		inline traceur::Ray operator()(const glm::vec2 &win) const noexcept
+		{
+			auto step = win.x * dx + win.y * dy;
+			return ray(nearPoint + step, farPoint + step);
+		}
+
+		/**
+		 * Create the rays of a row of pixels, which shares the computation of
+		 * the row between the pixels.
+		 *
+		 * @param[in] win The window coordinates of the first pixel.
+		 * @param[in] count The amount of pixels in the row.
+		 * @param[out] rays The rays through the pixels.
+		 */
+		inline void row(const glm::vec2 &win, int count, traceur::Ray *rays) const noexcept
+		{
+			auto step = win.y * dy;
+			auto first = nearPoint + step;
+			auto last = farPoint + step;
+
+			for (int i = 0; i < count; i++) {
+				auto column = (win.x + i) * dx;
+				rays[i] = ray(first + column, last + column);
+			}
+		}
+	private:
+		/**
+		 * Create the ray between the given homogeneous points.
+		 *
+		 * @param[in] origin The origin of the ray.
+		 * @param[in] destination The destination of the ray.
+		 * @return The ray between the points.
+		 */
+		static inline traceur::Ray ray(const glm::vec4 &origin, const glm::vec4 &destination) noexcept
+		{
+			auto from = glm::vec3(origin) / origin.w;
+			auto to = glm::vec3(destination) / destination.w;
+			return traceur::Ray(from, glm::normalize(to - from));
+		}
+	};
 }
 
 #endif /* TRACEUR_CORE_SCENE_CAMERA_H */
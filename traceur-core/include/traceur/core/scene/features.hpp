@@ -0,0 +1,173 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SCENE_FEATURES_H
+#define TRACEUR_CORE_SCENE_FEATURES_H
+
+#include <algorithm>
+
+#include <traceur/core/scene/graph/visitor.hpp>
+#include <traceur/core/material/material.hpp>
+#include <traceur/core/scene/primitive/primitive.hpp>
+#include <traceur/core/scene/primitive/sphere.hpp>
+#include <traceur/core/scene/primitive/triangle.hpp>
+#include <traceur/core/scene/primitive/box.hpp>
+
+namespace traceur {
+	/**
+	 * The features that are used by the geometry of a {@link Scene}, which
+	 * allow a {@link Kernel} to be specialized for the scene.
+	 *
+	 * The geometric features are collected by visiting the primitives of a
+	 * scene, either by a loader while it constructs the primitives, or
+	 * afterwards by letting the {@link SceneGraph} accept this visitor. The
+	 * features of the materials are recorded for each material that is used
+	 * by the primitives.
+	 */
+	class SceneFeatures: public SceneGraphVisitor {
+	public:
+		using traceur::SceneGraphVisitor::visit;
+
+		/**
+		 * The features a kernel can be specialized on.
+		 */
+		enum Feature : unsigned {
+			/**
+			 * The scene contains materials that reflect the scene.
+			 */
+			Reflection = 1 << 0,
+
+			/**
+			 * The scene contains transparent or refracting materials.
+			 */
+			Transmission = 1 << 1,
+
+			/**
+			 * The scene contains too many lights to evaluate all of them at
+			 * every shading point.
+			 */
+			LightSampling = 1 << 2,
+
+			/**
+			 * All features a kernel can be specialized on.
+			 */
+			All = (1 << 3) - 1
+		};
+
+		/**
+		 * The highest illumination model of the materials in the scene, or
+		 * <code>-1</code> if the scene is empty.
+		 */
+		int maxIlluminationModel;
+
+		/**
+		 * A flag to indicate the scene contains transparent or refracting
+		 * materials.
+		 */
+		bool transmission;
+
+		/**
+		 * A flag to indicate the scene contains spheres.
+		 */
+		bool spheres;
+
+		/**
+		 * A flag to indicate the scene contains triangles.
+		 */
+		bool triangles;
+
+		/**
+		 * A flag to indicate the scene contains boxes.
+		 */
+		bool boxes;
+
+		/**
+		 * Construct a {@link SceneFeatures} instance of an empty scene.
+		 */
+		SceneFeatures() :
+			maxIlluminationModel(-1), transmission(false), spheres(false), triangles(false), boxes(false) {}
+
+		/**
+		 * Return the mask of the features of the materials in the scene.
+		 * Whether lights must be sampled depends on the lights of the scene
+		 * and the kernel, so {@link Feature::LightSampling} is never set.
+		 *
+		 * @return The mask of {@link Feature} values.
+		 */
+		inline unsigned mask() const
+		{
+			unsigned mask = 0;
+			if (maxIlluminationModel >= 3) {
+				mask |= Reflection;
+			}
+			if (transmission) {
+				mask |= Transmission;
+			}
+			return mask;
+		}
+
+		/**
+		 * Record a material that is used in the scene.
+		 *
+		 * @param[in] material The material to record.
+		 */
+		inline void add(const traceur::Material &material)
+		{
+			int model = material.illuminationModel;
+			maxIlluminationModel = std::max(maxIlluminationModel, model);
+			transmission = transmission || model == 4 || model == 6 || model == 7;
+		}
+
+		/**
+		 * Visit a {@link Sphere} primitive in the scene graph.
+		 *
+		 * @param[in] node The node to visit.
+		 */
+		virtual void visit(const traceur::Sphere &) override
+		{
+			spheres = true;
+		}
+
+		/**
+		 * Visit a {@link Triangle} primitive in the scene graph.
+		 *
+		 * @param[in] node The node to visit.
+		 */
+		virtual void visit(const traceur::Triangle &) override
+		{
+			triangles = true;
+		}
+
+		/**
+		 * Visit a {@link Box} primitive in the scene graph.
+		 *
+		 * @param[in] node The node to visit.
+		 */
+		virtual void visit(const traceur::Box &) override
+		{
+			boxes = true;
+		}
+	};
+}
+
+#endif /* TRACEUR_CORE_SCENE_FEATURES_H */
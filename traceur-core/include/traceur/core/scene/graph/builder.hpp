@@ -26,6 +26,7 @@
 
 #include <memory>
 
+#include <traceur/core/memory/arena.hpp>
 #include <traceur/core/scene/graph/graph.hpp>
 #include <traceur/core/scene/primitive/primitive.hpp>
 
@@ -35,7 +36,19 @@ namespace traceur {
 	 * representations of the scene.
 	 */
 	class SceneGraphBuilder {
+	protected:
+		/**
+		 * The arena into which the primitives added to this builder are
+		 * placed. The primitives keep the arena alive through the shared
+		 * pointers that are handed out for them.
+		 */
+		std::shared_ptr<traceur::Arena> arena;
 	public:
+		/**
+		 * Construct a {@link SceneGraphBuilder} instance.
+		 */
+		SceneGraphBuilder() : arena(std::make_shared<traceur::Arena>()) {}
+
 		/**
 		 * Deconstruct the {@link SceneGraphBuilder} instance.
 		 */
@@ -49,15 +62,18 @@ namespace traceur {
 		virtual void add(const std::shared_ptr<traceur::Primitive>) = 0;
 
 		/**
-		 * Add a node to the graph of the scene.
+		 * Add a node to the graph of the scene, which is copied into the
+		 * arena of this builder.
 		 *
 		 * @param[in] node The node to add to the scene.
 		 */
 		template<typename T>
 		inline void add(const T &primitive)
 		{
-			add(std::shared_ptr<traceur::Primitive>(new T(primitive)));
+			T *copy = arena->create<T>(primitive);
+			add(std::shared_ptr<traceur::Primitive>(arena, copy));
 		}
+
 		/**
 		 * Build a {@link SceneGraph} from the current geometry given to this
 		 * builder.
@@ -0,0 +1,57 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SCENE_GRAPH_DISPATCH_H
+#define TRACEUR_CORE_SCENE_GRAPH_DISPATCH_H
+
+#include <traceur/core/scene/graph/graph.hpp>
+#include <traceur/core/scene/graph/kdtree.hpp>
+#include <traceur/core/scene/graph/vector.hpp>
+
+namespace traceur {
+	/**
+	 * Invoke the given function object with the given graph cast to its
+	 * concrete type, so the function object can be instantiated for the
+	 * graphs that the builders produce and intersect them without virtual
+	 * calls. Other graphs are passed as a {@link SceneGraph}.
+	 *
+	 * The type is determined once by the caller, e.g. once per render job,
+	 * and not for every ray.
+	 *
+	 * @param[in] graph The graph to pass to the function object.
+	 * @param[in] function The generic function object to invoke.
+	 * @return The result of the function object.
+	 */
+	template<class Function>
+	inline auto visit_graph(const traceur::SceneGraph &graph, Function &&function) -> decltype(function(graph))
+	{
+		if (auto kdtree = dynamic_cast<const traceur::KDTreeSceneGraph *>(&graph)) {
+			return function(*kdtree);
+		} else if (auto vector = dynamic_cast<const traceur::VectorSceneGraph *>(&graph)) {
+			return function(*vector);
+		}
+		return function(graph);
+	}
+}
+
+#endif /* TRACEUR_CORE_SCENE_GRAPH_DISPATCH_H */
@@ -24,6 +24,7 @@
 #ifndef TRACEUR_CORE_SCENE_GRAPH_FACTORY_H
 #define TRACEUR_CORE_SCENE_GRAPH_FACTORY_H
 
+#include <functional>
 #include <memory>
 
 #include <traceur/core/scene/graph/builder.hpp>
@@ -59,18 +60,23 @@ namespace traceur {
 	template<typename T, typename... Args>
 	std::unique_ptr<SceneGraphBuilderFactory> make_factory(Args&&... args)
 	{
+		using Function = std::function<std::unique_ptr<traceur::SceneGraphBuilder>()>;
+
 		class Factory: public SceneGraphBuilderFactory {
-			std::tuple<Args&&...> args;
+			Function function;
 		public:
-			Factory(Args&&... args) : args(std::forward<Args>(args)...) {}
+			Factory(Function function) : function(std::move(function)) {}
 
 			virtual std::unique_ptr<traceur::SceneGraphBuilder> create() const
 			{
-				return std::make_unique<T>(std::forward<Args>(args)...);
+				return function();
 			}
 		};
 
-		return std::make_unique<Factory>(std::forward<Args>(args)...);
+		/* Copy the arguments, since every builder is constructed from them */
+		return std::make_unique<Factory>([=]() -> std::unique_ptr<traceur::SceneGraphBuilder> {
+			return std::make_unique<T>(args...);
+		});
 	}
 }
 
@@ -43,7 +43,8 @@ namespace traceur {
 
 		/**
 		 * Determine which primitive the given ray intersects in the
-		 * geometry of this graph.
+		 * geometry of this graph. The position and normal of the nearest hit
+		 * are computed after traversal.
 		 *
 		 * @param[in] ray The ray to intersect with a shape.
 		 * @param[in] hit The intersection structure to which the details will
@@ -53,6 +54,59 @@ namespace traceur {
 		 */
 		virtual bool intersect(const traceur::Ray &, traceur::Hit &) const = 0;
 
+		/**
+		 * Determine whether the given ray intersects any primitive in the
+		 * geometry of this graph before the given distance. Unlike
+		 * {@link SceneGraph#intersect(const Ray &, Hit &)}, the traversal may
+		 * stop at the first such primitive.
+		 *
+		 * @param[in] ray The ray to intersect with the geometry.
+		 * @param[in] distance The distance along the ray up to which the
+		 * ray is tested.
+		 * @return <code>true</code> if a primitive occludes the ray,
+		 * otherwise <code>false</code>.
+		 */
+		virtual bool occluded(const traceur::Ray &ray, float distance) const
+		{
+			traceur::Hit hit;
+			return intersect(ray, hit) && hit.distance < distance;
+		}
+
+		/**
+		 * Determine the nearest hit of each ray of a batch in the geometry of
+		 * this graph.
+		 *
+		 * @param[in] rays The rays to intersect with the geometry.
+		 * @param[out] hits The nearest hit of each ray, of which the
+		 * primitive is <code>nullptr</code> if the ray misses the geometry.
+		 * @param[in] count The amount of rays in the batch.
+		 */
+		virtual void intersect(const traceur::Ray *rays, traceur::Hit *hits, size_t count) const
+		{
+			for (size_t i = 0; i < count; i++) {
+				if (!intersect(rays[i], hits[i])) {
+					hits[i].primitive = nullptr;
+				}
+			}
+		}
+
+		/**
+		 * Determine for each ray of a batch whether it is occluded before
+		 * its distance, for instance to test the visibility between pairs of
+		 * points.
+		 *
+		 * @param[in] rays The rays to intersect with the geometry.
+		 * @param[in] distances The distance up to which each ray is tested.
+		 * @param[out] results Whether each ray is occluded.
+		 * @param[in] count The amount of rays in the batch.
+		 */
+		virtual void occluded(const traceur::Ray *rays, const float *distances, bool *results, size_t count) const
+		{
+			for (size_t i = 0; i < count; i++) {
+				results[i] = occluded(rays[i], distances[i]);
+			}
+		}
+
 		/**
 		 * Accept a {@link SceneGraphVisitor} instance to traverse this scene
 		 * graph.
@@ -30,43 +30,106 @@
 
 #include <glm/glm.hpp>
 
+#include <traceur/core/math/simd.hpp>
+#include <traceur/core/memory/arena.hpp>
 #include <traceur/core/scene/graph/graph.hpp>
 #include <traceur/core/scene/graph/builder.hpp>
 #include <traceur/core/scene/primitive/box.hpp>
+#include <traceur/core/scene/primitive/sphere.hpp>
+#include <traceur/core/scene/primitive/triangle.hpp>
 
 namespace traceur {
 	/* Forward Declarations */
 	class KDTreeSceneGraphBuilder;
 
+	/**
+	 * The method by which the triangles in the leaves of a kd-tree are
+	 * intersected, which trades memory for intersection speed.
+	 */
+	enum class TriangleIntersector {
+		/**
+		 * Intersect the geometry of the triangles directly, which requires
+		 * no additional memory.
+		 */
+		Geometric,
+
+		/**
+		 * Intersect the triangles through a {@link TriangleTransform} that is
+		 * precomputed when the tree is built, which requires 48 additional
+		 * bytes per triangle.
+		 */
+		Transform
+	};
+
 	/**
 	 * A {@link Node} in the kd-tree.
+	 *
+	 * The nodes of a tree and the primitives in its leaves are placed into
+	 * the {@link Arena} of the {@link KDTreeSceneGraph}, which owns them.
 	 */
 	class KDTreeNode : public Node {
 		/**
 		 * The left sub node of this node.
 		 */
-		std::unique_ptr<KDTreeNode> left;
+		traceur::KDTreeNode *left;
 
 		/**
 		 * The right sub node of this node.
 		 */
-		std::unique_ptr<KDTreeNode> right;
+		traceur::KDTreeNode *right;
 
 		/**
-		 * The primitives contained in this node.
+		 * The triangles contained in this node if it is a leaf.
+		 *
+		 * The primitives of a leaf are grouped by their concrete type into
+		 * contiguous arrays, so the traversal can call the (non-virtual)
+		 * intersector of each group without chasing pointers.
 		 */
-		std::vector<std::shared_ptr<traceur::Primitive>> primitives;
+		traceur::ArenaArray<traceur::Triangle> triangles;
+
+		/**
+		 * The precomputed transforms of the triangles contained in this node
+		 * in packets of four, which is either empty or covers the triangles
+		 * in order.
+		 */
+		traceur::ArenaArray<traceur::TrianglePacket> packets;
+
+		/**
+		 * The spheres contained in this node if it is a leaf.
+		 */
+		traceur::ArenaArray<traceur::Sphere> spheres;
+
+		/**
+		 * The boxes contained in this node if it is a leaf.
+		 */
+		traceur::ArenaArray<traceur::Box> boxes;
+
+		/**
+		 * The primitives of any other type contained in this node if it is a
+		 * leaf, which are intersected through virtual dispatch.
+		 */
+		traceur::ArenaArray<const traceur::Primitive *> primitives;
 
 		/**
-		 * The bounding {@link Box} of this node.
+		 * The bounding box of this node.
 		 */
-		traceur::Box box;
+		traceur::AABB box;
+
+		/**
+		 * The bounding box of this node, padded for the traversal.
+		 */
+		traceur::AlignedBox bounds;
 
 		/**
 		 * Allow a {@link KDTreeSceneGraphBuilder} to access our privates.
 		 */
 		friend KDTreeSceneGraphBuilder;
 	public:
+		/**
+		 * The maximum depth of a node in the tree.
+		 */
+		static const int MaximumDepth = 6;
+
 		/**
 		 * The depth of the node.
 		 */
@@ -75,7 +138,7 @@ namespace traceur {
 		/**
 		 * Construct a {@link KDTreeNode} instance.
 		 */
-		KDTreeNode() : depth(0), box(traceur::Box::createBoundingBox()) {}
+		KDTreeNode() : left(nullptr), right(nullptr), depth(0), box(traceur::AABB::empty()), bounds(box) {}
 
 		/**
 		 * Determine whether the given ray intersects a shape in the geometry
@@ -87,7 +150,28 @@ namespace traceur {
 		 * @return <code>true</code> if a shape intersects the ray, otherwise
 		 * <code>false</code>.
 		 */
-		virtual bool intersect(const traceur::Ray &, traceur::Hit &) const final;
+		inline virtual bool intersect(const traceur::Ray &ray, traceur::Hit &hit) const final
+		{
+			double dist = std::numeric_limits<double>::infinity();
+			return traverse<false>(ray, hit, dist);
+		}
+
+		/**
+		 * Determine whether the given ray intersects any shape in the
+		 * geometry of this graph before the given distance.
+		 *
+		 * @param[in] ray The ray to intersect with a shape.
+		 * @param[in] distance The distance along the ray up to which the
+		 * ray is tested.
+		 * @return <code>true</code> if a shape occludes the ray, otherwise
+		 * <code>false</code>.
+		 */
+		inline bool occluded(const traceur::Ray &ray, float distance) const
+		{
+			traceur::Hit hit;
+			double dist = distance;
+			return traverse<true>(ray, hit, dist);
+		}
 
 		/**
 		 * Accept a {@link SceneGraphVisitor} instance to visit this node in
@@ -98,47 +182,297 @@ namespace traceur {
 		virtual void accept(traceur::SceneGraphVisitor &) const final;
 
 		/**
-		 * Return the bounding {@link Box} which encapsulates the whole node.
+		 * Return the bounding box which encapsulates the whole node.
 		 *
-		 * @return A bounding {@link Box} of the node.
+		 * @return A bounding {@link AABB} of the node.
 		 */
-		virtual const Box & bounding_box() const final
+		virtual const traceur::AABB & bounding_box() const final
 		{
 			return box;
 		}
+	private:
+		/**
+		 * Traverse the tree to find the nearest hit of the given ray before
+		 * the given distance, or any such hit.
+		 *
+		 * @tparam Any A flag to stop at the first hit that is found.
+		 * @param[in] ray The ray to intersect with the tree.
+		 * @param[in] hit The nearest hit, which is updated if a nearer hit
+		 * is found.
+		 * @param[in] dist The distance to the nearest hit.
+		 * @return <code>true</code> if a nearer hit has been found, otherwise
+		 * <code>false</code>.
+		 */
+		template<bool Any>
+		inline bool traverse(const traceur::Ray &ray, traceur::Hit &hit, double &dist) const
+		{
+			/* The nodes that remain to be visited, of which the left node is
+			 * visited first */
+			const traceur::KDTreeNode *stack[MaximumDepth + 2];
+			int size = 0;
+			stack[size++] = this;
+
+			traceur::AlignedRay aligned(ray);
+
+			bool intersection = false;
+
+			while (size > 0) {
+				auto node = stack[--size];
+
+				/* Skip nodes which the ray misses or which lie behind the
+				 * nearest hit */
+				float tmin, tmax;
+				if (!node->bounds.intersect(aligned, tmin, tmax) || tmin > dist) {
+					continue;
+				}
+
+				if (node->left || node->right) {
+					if (node->right) {
+						stack[size++] = node->right;
+					}
+					if (node->left) {
+						stack[size++] = node->left;
+					}
+					continue;
+				}
+
+				/* Only leaves contain primitives */
+				if (node->packets.empty()) {
+					intersection |= intersect(node->triangles, ray, hit, dist);
+				} else {
+					intersection |= intersect(node->triangles, node->packets, aligned, hit, dist);
+				}
+				intersection |= intersect(node->spheres, ray, hit, dist);
+				intersection |= intersect(node->boxes, ray, hit, dist);
+				intersection |= intersect(node->primitives, ray, hit, dist);
+
+				if (Any && intersection) {
+					return true;
+				}
+			}
+
+			return intersection;
+		}
+
+		/**
+		 * Intersect a ray with a group of primitives of the same concrete
+		 * type, of which the intersection methods can be inlined.
+		 *
+		 * @param[in] group The primitives to intersect with.
+		 * @param[in] ray The ray to intersect with the primitives.
+		 * @param[in] hit The nearest hit, which is updated if a nearer hit
+		 * is found.
+		 * @param[in] dist The distance to the nearest hit.
+		 * @return <code>true</code> if a nearer hit has been found, otherwise
+		 * <code>false</code>.
+		 */
+		template<typename T>
+		static inline bool intersect(const traceur::ArenaArray<T> &group,
+									 const traceur::Ray &ray,
+									 traceur::Hit &hit,
+									 double &dist)
+		{
+			traceur::Hit candidate;
+			bool intersection = false;
+
+			for (auto &primitive : group) {
+				/* Test if ray intersects bounding box of primitive */
+				if (!primitive.bounding_box().intersects(ray)) {
+					continue;
+				}
+
+				/* Test if ray intersects primitive */
+				if (primitive.intersect(ray, candidate) && candidate.distance < dist) {
+					hit = candidate;
+					dist = candidate.distance;
+					intersection = true;
+				}
+			}
+			return intersection;
+		}
+
+		/**
+		 * Intersect a ray with a group of triangles through their
+		 * precomputed transforms, four triangles at a time.
+		 *
+		 * @param[in] triangles The triangles to intersect with.
+		 * @param[in] packets The transforms of the triangles.
+		 * @param[in] ray The ray to intersect with the triangles.
+		 * @param[in] hit The nearest hit, which is updated if a nearer hit
+		 * is found.
+		 * @param[in] dist The distance to the nearest hit.
+		 * @return <code>true</code> if a nearer hit has been found, otherwise
+		 * <code>false</code>.
+		 */
+		static inline bool intersect(const traceur::ArenaArray<traceur::Triangle> &triangles,
+									 const traceur::ArenaArray<traceur::TrianglePacket> &packets,
+									 const traceur::AlignedRay &ray,
+									 traceur::Hit &hit,
+									 double &dist)
+		{
+			bool intersection = false;
+
+			for (size_t i = 0; i < packets.size(); i++) {
+				traceur::Float4 t, a, b;
+				int mask = packets[i].intersect(ray, t, a, b);
+
+				/* Visit the hits in order, like the triangles are */
+				for (int j = 0; mask; j++, mask >>= 1) {
+					if ((mask & 1) && t[j] < dist) {
+						hit.primitive = &triangles[i * traceur::TrianglePacket::Width + j];
+						hit.distance = t[j];
+						hit.u = a[j];
+						hit.v = b[j];
+						dist = hit.distance;
+						intersection = true;
+					}
+				}
+			}
+			return intersection;
+		}
+
+		/**
+		 * Intersect a ray with a group of primitives of other types, which
+		 * are intersected through virtual dispatch.
+		 *
+		 * @param[in] group The primitives to intersect with.
+		 * @param[in] ray The ray to intersect with the primitives.
+		 * @param[in] hit The nearest hit, which is updated if a nearer hit
+		 * is found.
+		 * @param[in] dist The distance to the nearest hit.
+		 * @return <code>true</code> if a nearer hit has been found, otherwise
+		 * <code>false</code>.
+		 */
+		static inline bool intersect(const traceur::ArenaArray<const traceur::Primitive *> &group,
+									 const traceur::Ray &ray,
+									 traceur::Hit &hit,
+									 double &dist)
+		{
+			traceur::Hit candidate;
+			bool intersection = false;
+
+			for (auto &primitive : group) {
+				/* Test if ray intersects bounding box of primitive */
+				if (!primitive->bounding_box().intersects(ray)) {
+					continue;
+				}
+
+				/* Test if ray intersects primitive */
+				if (primitive->intersect(ray, candidate) && candidate.distance < dist) {
+					hit = candidate;
+					dist = candidate.distance;
+					intersection = true;
+				}
+			}
+			return intersection;
+		}
 	};
+
 	/**
 	 * A {@link SceneGraph> which is represented by a kd-tree.
 	 */
 	class KDTreeSceneGraph: public SceneGraph {
+		/**
+		 * The arena which contains the nodes of this tree.
+		 */
+		std::shared_ptr<traceur::Arena> arena;
+
 		/**
 		 * The root node of this tree.
 		 */
-		std::unique_ptr<traceur::KDTreeNode> root;
+		const traceur::KDTreeNode *root;
+
+		/**
+		 * The primitives of other types than those stored in the arena,
+		 * which are referenced by the leaves of the tree.
+		 */
+		std::vector<std::shared_ptr<traceur::Primitive>> primitives;
 
 		/**
 		 * The nodes in the tree.
 		 */
 		size_t nodes;
 	public:
+		using traceur::SceneGraph::intersect;
+		using traceur::SceneGraph::occluded;
+
 		/**
 		 * Construct a {@link KDTreeSceneGraph} instance.
 		 *
+		 * @param[in] arena The arena which contains the nodes of the tree.
 		 * @param[in] root The root node of the tree.
+		 * @param[in] primitives The primitives referenced by the leaves of
+		 * the tree that are not contained in the arena.
+		 * @param[in] nodes The number of primitives in the tree.
 		 */
-		KDTreeSceneGraph(std::unique_ptr<traceur::KDTreeNode> root, int nodes) : root(std::move(root)), nodes(nodes) {}
+		KDTreeSceneGraph(std::shared_ptr<traceur::Arena> arena,
+						 const traceur::KDTreeNode *root,
+						 std::vector<std::shared_ptr<traceur::Primitive>> primitives,
+						 size_t nodes)
+			: arena(std::move(arena)), root(root), primitives(std::move(primitives)), nodes(nodes) {}
 
 		/**
 		 * Determine whether the given ray intersects a node in the geometry
 		 * of this container.
 		 *
+		 * The traversal is inlined into callers that know the type of the
+		 * graph, and is then compiled for their instruction set.
+		 *
 		 * @param[in] ray The ray to intersect with a shape.
 		 * @param[in] hit The intersection structure to which the details will
 		 * be written to.
 		 * @return <code>true</code> if a shape intersects the ray, otherwise
 		 * <code>false</code>.
 		 */
-		virtual bool intersect(const traceur::Ray &, traceur::Hit &) const final;
+		inline virtual bool intersect(const traceur::Ray &ray, traceur::Hit &hit) const final
+		{
+			if (!root->intersect(ray, hit)) {
+				return false;
+			}
+
+			/* Compute the attributes of the nearest hit only */
+			hit.primitive->finalize(ray, hit);
+			return true;
+		}
+
+		/**
+		 * Determine whether the given ray intersects any shape in the
+		 * geometry of this container before the given distance.
+		 *
+		 * @param[in] ray The ray to intersect with a shape.
+		 * @param[in] distance The distance along the ray up to which the
+		 * ray is tested.
+		 * @return <code>true</code> if a shape occludes the ray, otherwise
+		 * <code>false</code>.
+		 */
+		inline virtual bool occluded(const traceur::Ray &ray, float distance) const final
+		{
+			return root->occluded(ray, distance);
+		}
+
+		/**
+		 * Determine the nearest hit of each ray of a batch in the geometry of
+		 * this graph, with the traversal compiled for the active instruction
+		 * set.
+		 *
+		 * @param[in] rays The rays to intersect with the geometry.
+		 * @param[out] hits The nearest hit of each ray, of which the
+		 * primitive is <code>nullptr</code> if the ray misses the geometry.
+		 * @param[in] count The amount of rays in the batch.
+		 */
+		virtual void intersect(const traceur::Ray *, traceur::Hit *, size_t) const final;
+
+		/**
+		 * Determine for each ray of a batch whether it is occluded before
+		 * its distance, with the traversal compiled for the active
+		 * instruction set.
+		 *
+		 * @param[in] rays The rays to intersect with the geometry.
+		 * @param[in] distances The distance up to which each ray is tested.
+		 * @param[out] results Whether each ray is occluded.
+		 * @param[in] count The amount of rays in the batch.
+		 */
+		virtual void occluded(const traceur::Ray *, const float *, bool *, size_t) const final;
 
 		/**
 		 * Return the amount of nodes in the graph.
@@ -166,19 +500,50 @@ namespace traceur {
 		 */
 		std::vector<std::shared_ptr<traceur::Primitive>> primitives;
 
+		/**
+		 * The method by which the triangles in the tree are intersected.
+		 */
+		traceur::TriangleIntersector intersector;
+
 		/**
 		 * Build a {@link KDTreeNode} recursively from the given primitives.
 		 *
 		 * @param[in] primitives The primitives to build the node from.
 		 * @param[in] depth The depth of the node.
-		 * @return The {@link KDTreeNode} to take ownership over.
+		 * @param[in] arena The arena into which the node is placed.
+		 * @param[in] owners The primitives referenced by the leaves that are
+		 * not copied into the arena.
+		 * @return The {@link KDTreeNode} owned by the arena.
 		 */
-		std::unique_ptr<traceur::KDTreeNode> build(const std::vector<std::shared_ptr<traceur::Primitive>> &, int) const;
+		traceur::KDTreeNode * build(const std::vector<std::shared_ptr<traceur::Primitive>> &,
+									int,
+									traceur::Arena &,
+									std::vector<std::shared_ptr<traceur::Primitive>> &) const;
+
+		/**
+		 * Turn the given {@link KDTreeNode} into a leaf that contains the
+		 * given primitives, grouped by their concrete type.
+		 *
+		 * @param[in] node The node to turn into a leaf.
+		 * @param[in] primitives The primitives contained in the leaf.
+		 * @param[in] arena The arena into which the primitives are copied.
+		 * @param[in] owners The primitives referenced by the leaves that are
+		 * not copied into the arena.
+		 * @return The {@link KDTreeNode} owned by the arena.
+		 */
+		traceur::KDTreeNode * leaf(traceur::KDTreeNode *,
+								   const std::vector<std::shared_ptr<traceur::Primitive>> &,
+								   traceur::Arena &,
+								   std::vector<std::shared_ptr<traceur::Primitive>> &) const;
 	public:
 		/**
 		 * Construct a {@link KDTreeSceneGraphBuilder} instance.
+		 *
+		 * @param[in] intersector The method by which the triangles in the
+		 * tree are intersected.
 		 */
-		KDTreeSceneGraphBuilder() {}
+		KDTreeSceneGraphBuilder(traceur::TriangleIntersector intersector = traceur::TriangleIntersector::Geometric)
+			: intersector(intersector) {}
 
 		/**
 		 * Add a node to the graph of the scene.
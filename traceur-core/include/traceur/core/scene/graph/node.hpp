@@ -27,6 +27,7 @@
 #include <traceur/core/scene/graph/visitor.hpp>
 #include <traceur/core/kernel/ray.hpp>
 #include <traceur/core/kernel/hit.hpp>
+#include <traceur/core/scene/aabb.hpp>
 
 namespace traceur {
 	/**
@@ -61,6 +62,9 @@ namespace traceur {
 		 * Determine whether the given ray intersects a shape in the geometry
 		 * of this graph.
 		 *
+		 * Only the distance, primitive and barycentric coordinates of the hit
+		 * are written; see {@link Primitive#finalize(const Ray &, Hit &)}.
+		 *
 		 * @param[in] ray The ray to intersect with a shape.
 		 * @param[in] hit The intersection structure to which the details will
 		 * be written to.
@@ -88,11 +92,11 @@ namespace traceur {
 		}
 
 		/**
-		 * Return the bounding {@link Box} which encapsulates the whole node.
+		 * Return the bounding box which encapsulates the whole node.
 		 *
-		 * @return A bounding {@link Box} of the node.
+		 * @return A bounding {@link AABB} of the node.
 		 */
-		virtual const Box & bounding_box() const = 0;
+		virtual const traceur::AABB & bounding_box() const = 0;
 	};
 }
 
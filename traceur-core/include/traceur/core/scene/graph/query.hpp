@@ -0,0 +1,101 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_SCENE_GRAPH_QUERY_H
+#define TRACEUR_CORE_SCENE_GRAPH_QUERY_H
+
+#include <functional>
+
+#include <traceur/core/kernel/multithreaded.hpp>
+#include <traceur/core/scene/graph/graph.hpp>
+
+namespace traceur {
+	/**
+	 * An engine that answers large batches of ray queries against a
+	 * {@link SceneGraph} outside of rendering, for instance visibility tests
+	 * between many pairs of points. A batch is divided into contiguous
+	 * chunks, which are queried by the batch methods of the graph on a
+	 * thread pool.
+	 */
+	class RayQueryEngine {
+	public:
+		/**
+		 * The amount of worker threads of the engine.
+		 */
+		const int workers;
+
+		/**
+		 * The amount of rays that a worker queries at once. Batches that do
+		 * not exceed this size are queried on the calling thread.
+		 */
+		size_t chunkSize;
+
+		/**
+		 * Construct a {@link RayQueryEngine} instance.
+		 *
+		 * @param[in] workers The amount of worker threads to spawn.
+		 * @param[in] chunkSize The amount of rays a worker queries at once.
+		 */
+		RayQueryEngine(int, size_t = 4096);
+
+		/**
+		 * Determine the nearest hit of each ray of a batch in the geometry of
+		 * the given graph.
+		 *
+		 * @param[in] graph The graph to query.
+		 * @param[in] rays The rays to intersect with the geometry.
+		 * @param[out] hits The nearest hit of each ray, of which the
+		 * primitive is <code>nullptr</code> if the ray misses the geometry.
+		 * @param[in] count The amount of rays in the batch.
+		 */
+		void intersect(const traceur::SceneGraph &, const traceur::Ray *, traceur::Hit *, size_t) const;
+
+		/**
+		 * Determine for each ray of a batch whether it is occluded in the
+		 * geometry of the given graph before its distance.
+		 *
+		 * @param[in] graph The graph to query.
+		 * @param[in] rays The rays to intersect with the geometry.
+		 * @param[in] distances The distance up to which each ray is tested.
+		 * @param[out] results Whether each ray is occluded.
+		 * @param[in] count The amount of rays in the batch.
+		 */
+		void occluded(const traceur::SceneGraph &, const traceur::Ray *, const float *, bool *, size_t) const;
+	private:
+		/**
+		 * Run a query over a batch in chunks on the thread pool.
+		 *
+		 * @param[in] count The amount of rays in the batch.
+		 * @param[in] query The query to run for a chunk, which receives the
+		 * index of its first ray and its size.
+		 */
+		void run(size_t, const std::function<void(size_t, size_t)> &) const;
+
+		/**
+		 * The thread pool the engine uses.
+		 */
+		mutable traceur::MultithreadedKernelPool pool;
+	};
+}
+
+#endif /* TRACEUR_CORE_SCENE_GRAPH_QUERY_H */
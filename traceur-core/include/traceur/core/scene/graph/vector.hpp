@@ -32,7 +32,7 @@
 
 #include <traceur/core/scene/graph/graph.hpp>
 #include <traceur/core/scene/graph/builder.hpp>
-#include <traceur/core/scene/primitive/box.hpp>
+#include <traceur/core/scene/aabb.hpp>
 
 namespace traceur {
 	/**
@@ -48,8 +48,11 @@ namespace traceur {
 		/**
 		 * The bounding box of this graph.
 		 */
-		const traceur::Box box;
+		const traceur::AABB box;
 	public:
+		using traceur::SceneGraph::intersect;
+		using traceur::SceneGraph::occluded;
+
 		/**
 		 * Construct a {@link VectorSceneGraph} instance.
 		 *
@@ -57,7 +60,7 @@ namespace traceur {
 		 * @param[in] box The bounding box of this graph.
 		 */
 		VectorSceneGraph(const std::vector<std::shared_ptr<traceur::Primitive>> &nodes,
-						 const traceur::Box &box
+						 const traceur::AABB &box
 		) : box(box), nodes(nodes) {}
 
 		/**
@@ -70,7 +73,63 @@ namespace traceur {
 		 * @return <code>true</code> if a shape intersects the ray, otherwise
 		 * <code>false</code>.
 		 */
-		virtual bool intersect(const traceur::Ray &, traceur::Hit &) const final;
+		inline virtual bool intersect(const traceur::Ray &ray, traceur::Hit &hit) const final
+		{
+			/* Test if ray intersects the bounding box of the scene graph */
+			if (!box.intersects(ray)) {
+				return false;
+			}
+
+			traceur::Hit candidate;
+			double dist = std::numeric_limits<double>::infinity();
+			bool intersection = false;
+
+			for (auto &primitive : nodes) {
+				/* Test if ray intersects bounding box of primitive */
+				if (!primitive->bounding_box().intersects(ray)) {
+					continue;
+				}
+
+				/* Test if ray intersects primitive */
+				if (primitive->intersect(ray, candidate) && candidate.distance < dist) {
+					hit = candidate;
+					dist = candidate.distance;
+					intersection = true;
+				}
+			}
+
+			if (intersection) {
+				/* Compute the attributes of the nearest hit only */
+				hit.primitive->finalize(ray, hit);
+			}
+			return intersection;
+		}
+
+		/**
+		 * Determine whether the given ray intersects any node in the
+		 * geometry of this container before the given distance.
+		 *
+		 * @param[in] ray The ray to intersect with a shape.
+		 * @param[in] distance The distance along the ray up to which the
+		 * ray is tested.
+		 * @return <code>true</code> if a shape occludes the ray, otherwise
+		 * <code>false</code>.
+		 */
+		inline virtual bool occluded(const traceur::Ray &ray, float distance) const final
+		{
+			if (!box.intersects(ray)) {
+				return false;
+			}
+
+			traceur::Hit candidate;
+			for (auto &primitive : nodes) {
+				if (primitive->bounding_box().intersects(ray)
+					&& primitive->intersect(ray, candidate) && candidate.distance < distance) {
+					return true;
+				}
+			}
+			return false;
+		}
 
 		/**
 		 * Accept a {@link SceneGraphVisitor} instance to traverse this scene
@@ -89,11 +148,11 @@ namespace traceur {
 		virtual size_t size() const final;
 
 		/**
-		 * Return the bounding {@link Box} which encapsulates the whole node.
+		 * Return the bounding box which encapsulates the whole node.
 		 *
-		 * @return A bounding {@link Box} of the node.
+		 * @return A bounding {@link AABB} of the node.
 		 */
-		virtual const Box & bounding_box() const final
+		virtual const traceur::AABB & bounding_box() const final
 		{
 			return box;
 		}
@@ -111,12 +170,12 @@ namespace traceur {
 		/**
 		 * The bounding box of the graph.
 		 */
-		traceur::Box box;
+		traceur::AABB box;
 	public:
 		/**
 		 * Construct a {@link VectorSceneGraphBuilder} instance.
 		 */
-		VectorSceneGraphBuilder() : box(traceur::Box::createBoundingBox()) {}
+		VectorSceneGraphBuilder() : box(traceur::AABB::empty()) {}
 
 		/**
 		 * Add a node to the graph of the scene.
@@ -24,74 +24,26 @@
 #ifndef TRACEUR_CORE_SCENE_PRIMITIVE_BOX_H
 #define TRACEUR_CORE_SCENE_PRIMITIVE_BOX_H
 
-#include <limits>
 #include <traceur/core/scene/primitive/primitive.hpp>
+#include <traceur/core/scene/aabb.hpp>
 
 namespace traceur {
 	/**
 	 * A primitive that represents a box.
 	 */
-	class Box : public Primitive {
+	class Box : public Primitive, public AABB {
 	public:
-		/**
-		 * An axis of the box.
-		 */
-		enum class Axis: int {
-			X = 0, Y = 1, Z = 2
-		};
-
-		/**
-		 * The minimum vertex in the box.
-		 */
-		glm::vec3 min;
-
-		/**
-		 * The maximum vertex in the box.
-		 */
-		glm::vec3 max;
+		using traceur::AABB::intersect;
 
 		/**
 		 * Construct a {@link Box} instance.
 		 *
-		 * @param[in] material The material of the primitive.
-		 */
-		Box(const std::shared_ptr<traceur::Material> material) :
-				Primitive(glm::vec3(), material), min(glm::vec3()), max(glm::vec3()) {}
-
-		/**
-		 * Construct a {@link Box} instance.
-		 *
-		 * @param[in] min The minimum vertex in the box.
-		 * @param[in] max The maximum vertex in the box.
-		 * @param[in] material The material of the primitive.
-		 */
-		Box(const glm::vec3 &min, const glm::vec3 max,
-			const std::shared_ptr<traceur::Material> material) :
-				Primitive((min + max) / 2.f, material), min(min), max(max) {}
-
-		/**
-		 * Construct a {@link Box} as bounding box.
-		 *
-		 * @return The bounding box instance.
-		 */
-		static Box createBoundingBox()
-		{
-			auto min = glm::vec3(std::numeric_limits<float>::infinity());
-			auto max = -min;
-			return createBoundingBox(min, max);
-		}
-
-		/**
-		 * Construct a {@link Box} as bounding box.
-		 *
 		 * @param[in] min The minimum vertex in the box.
 		 * @param[in] max The maximum vertex in the box.
-		 * @return The bounding box instance.
+		 * @param[in] material The index of the material of the primitive.
 		 */
-		static Box createBoundingBox(const glm::vec3 &min, const glm::vec3 &max)
-		{
-			return Box(min, max, std::make_shared<traceur::Material>());
-		}
+		Box(const glm::vec3 &min, const glm::vec3 &max, uint32_t material) :
+				Primitive((min + max) / 2.f, material), AABB(min, max) {}
 
 		/**
 		 * Determine whether the given ray intersects the shape.
@@ -104,37 +56,15 @@ namespace traceur {
 		 */
 		inline virtual bool intersect(const traceur::Ray &ray, traceur::Hit &hit) const final
 		{
-			/* TODO precalculate inverse */
-			glm::vec3 inverse = 1.0f / ray.direction;
-			auto u = (min - ray.origin) * inverse;
-			auto v = (max - ray.origin) * inverse;
-
-			float tmin = std::fmax(std::fmax(std::fmin(u[0], v[0]), std::fmin(u[1], v[1])), std::fmin(u[2], v[2]));
-			float tmax = std::fmin(std::fmin(std::fmax(u[0], v[0]), std::fmax(u[1], v[1])), std::fmax(u[2], v[2]));
-
-			if (tmax < 0)
-				return false;
-			if (tmin > tmax)
+			float tmin, tmax;
+			if (!intersect(ray, tmin, tmax))
 				return false;
 
 			hit.primitive = this;
 			hit.distance = tmin;
-			hit.position = ray.origin + tmin * ray.direction;
 			return true;
 		}
 
-		/**
-		 * Expand this {@link Box} with another box.
-		 *
-		 * @param[in] other The other box to expand with.
-		 * @return The next expanded box with the material properties of this
-		 * instance.
-		 */
-		traceur::Box expand(const traceur::Box &other) const
-		{
-			return traceur::Box(glm::min(min, other.min), glm::max(max, other.max), material);
-		}
-
 		/**
 		 * Accept a {@link SceneGraphVisitor} instance to visit this node in
 		 * the graph of the scene.
@@ -147,32 +77,16 @@ namespace traceur {
 		}
 
 		/**
-		 * Return the bounding {@link Box} which encapsulates the whole
-		 * primitive.
+		 * Return the bounding box which encapsulates the whole primitive.
 		 *
-		 * @return The bounding {@link Box} instance.
+		 * @return The bounding {@link AABB} instance.
 		 */
-		virtual const traceur::Box & bounding_box() const final
+		virtual const traceur::AABB & bounding_box() const final
 		{
 			return *this;
 		}
-
-		/**
-		 * Return the longest axis of this box.
-		 *
-		 * @return The longest axis of the box.
-		 */
-		traceur::Box::Axis longestAxis() const {
-			auto length = max - min;
-
-			if (length.x > length.y && length.x > length.z)
-				return traceur::Box::Axis::X;
-			if (length.y > length.x && length.y > length.z)
-				return traceur::Box::Axis::Y;
-			return traceur::Box::Axis::Z;
-		}
 	};
 }
 
-#endif /* TRACEUR_CORE_SCENE_PRIMITIVE_PRIMITIVE_H */
+#endif /* TRACEUR_CORE_SCENE_PRIMITIVE_BOX_H */
 
@@ -24,11 +24,10 @@
 #ifndef TRACEUR_CORE_SCENE_PRIMITIVE_PRIMITIVE_H
 #define TRACEUR_CORE_SCENE_PRIMITIVE_PRIMITIVE_H
 
-#include <memory>
+#include <cstdint>
 
 #include <traceur/core/scene/graph/node.hpp>
 #include <traceur/core/scene/graph/visitor.hpp>
-#include <traceur/core/material/material.hpp>
 
 namespace traceur {
 	/**
@@ -40,23 +39,47 @@ namespace traceur {
 	class Primitive : public Node {
 	public:
 		/**
-		 * The material of the primitive.
+		 * The index of the material of the primitive in the material table
+		 * of the {@link Scene}.
 		 */
-		std::shared_ptr<traceur::Material> material;
+		uint32_t material;
+
+		/**
+		 * The identifier of the primitive, which is its index in the order
+		 * the primitives were added to the graph of the {@link Scene}.
+		 */
+		uint32_t id;
 
 		/**
 		 * Construct a {@link Primitive} instance.
 		 *
 		 * @param[in] origin The origin of the primitive.
-		 * @param[in] material The material of the primitive.
+		 * @param[in] material The index of the material of the primitive.
 		 */
-		Primitive(const glm::vec3 &origin, const std::shared_ptr<traceur::Material> material) :
-			Node(origin), material(material) {}
+		Primitive(const glm::vec3 &origin, uint32_t material) :
+			Node(origin), material(material), id(0) {}
 
 		/**
 		 * Deconstruct the {@link Primitive} instance.
 		 */
 		virtual ~Primitive() {}
+
+		/**
+		 * Compute the position and normal of a {@link Hit} with this
+		 * primitive from the distance and barycentric coordinates recorded
+		 * during intersection.
+		 *
+		 * This method is called once for the nearest hit of a ray, so that
+		 * the candidates that are discarded during traversal do not pay for
+		 * the computation of their attributes.
+		 *
+		 * @param[in] ray The ray that has hit this primitive.
+		 * @param[in] hit The hit to complete.
+		 */
+		inline virtual void finalize(const traceur::Ray &ray, traceur::Hit &hit) const
+		{
+			hit.position = ray.origin + hit.distance * ray.direction;
+		}
 	};
 }
 
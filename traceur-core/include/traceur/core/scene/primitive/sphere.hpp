@@ -25,7 +25,7 @@
 #define TRACEUR_CORE_SCENE_PRIMITIVE_SPHERE_H
 
 #include <traceur/core/scene/primitive/primitive.hpp>
-#include <traceur/core/scene/primitive/box.hpp>
+#include <traceur/core/scene/aabb.hpp>
 
 namespace traceur {
 	/**
@@ -35,7 +35,7 @@ namespace traceur {
 		/**
 		 * The bounding box of this sphere.
 		 */
-		traceur::Box box;
+		traceur::AABB box;
 	public:
 		/**
 		 * The radius of the sphere.
@@ -47,11 +47,11 @@ namespace traceur {
 		 *
 		 * @param[in] center The center position of the sphere.
 		 * @param[in] radius The radius of the sphere.
-		 * @param[in] material The material of the sphere.
+		 * @param[in] material The index of the material of the sphere.
 		 */
-		Sphere(const glm::vec3 &center, float radius, const std::shared_ptr<traceur::Material> &material) :
+		Sphere(const glm::vec3 &center, float radius, uint32_t material) :
 			Primitive(center, material), radius(radius),
-			box(traceur::Box(center - glm::vec3(radius), center + glm::vec3(radius), material)) {}
+			box(center - glm::vec3(radius), center + glm::vec3(radius)) {}
 
 		/**
 		 * Determine whether the given ray intersects the shape.
@@ -81,11 +81,21 @@ namespace traceur {
 
 			hit.primitive = this;
 			hit.distance = lambda;
-			hit.position = ray.origin + lambda * ray.direction;
-			hit.normal = glm::normalize(hit.position - origin);
 			return true;
 		}
 
+		/**
+		 * Compute the position and normal of a {@link Hit} with this sphere.
+		 *
+		 * @param[in] ray The ray that has hit this sphere.
+		 * @param[in] hit The hit to complete.
+		 */
+		inline virtual void finalize(const traceur::Ray &ray, traceur::Hit &hit) const final
+		{
+			hit.position = ray.origin + hit.distance * ray.direction;
+			hit.normal = glm::normalize(hit.position - origin);
+		}
+
 		/**
 		 * Accept a {@link SceneGraphVisitor} instance to visit this node in
 		 * the graph of the scene.
@@ -98,12 +108,11 @@ namespace traceur {
 		}
 
 		/**
-		 * Return the bounding {@link Box} which encapsulates the whole
-		 * primitive.
+		 * Return the bounding box which encapsulates the whole primitive.
 		 *
-		 * @return The bounding {@link Box} instance.
+		 * @return The bounding {@link AABB} instance.
 		 */
-		virtual const traceur::Box & bounding_box() const final
+		virtual const traceur::AABB & bounding_box() const final
 		{
 			return box;
 		}
@@ -24,8 +24,9 @@
 #ifndef TRACEUR_CORE_SCENE_PRIMITIVE_TRIANGLE_H
 #define TRACEUR_CORE_SCENE_PRIMITIVE_TRIANGLE_H
 
+#include <traceur/core/math/simd.hpp>
 #include <traceur/core/scene/primitive/primitive.hpp>
-#include <traceur/core/scene/primitive/box.hpp>
+#include <traceur/core/scene/aabb.hpp>
 
 namespace traceur {
 	/**
@@ -35,7 +36,7 @@ namespace traceur {
 		/**
 		 * The bounding box of this triangle.
 		 */
-		traceur::Box box;
+		traceur::AABB box;
 	public:
 		/**
 		 * The vector to the second vertex of the triangle from the origin of
@@ -60,10 +61,10 @@ namespace traceur {
 		 * @param[in] origin The first vertex of the triangle.
 		 * @param[in] u The vector to the second component.
 		 * @param[in] v The vector to the third component.
-		 * @param[in] material The material of the triangle.
+		 * @param[in] material The index of the material of the triangle.
 		 */
-		Triangle(const glm::vec3 origin, const glm::vec3 &u, const glm::vec3 &v, const std::shared_ptr<traceur::Material> material) :
-			Primitive(origin, material), u(u), v(v), box(Box(material))
+		Triangle(const glm::vec3 origin, const glm::vec3 &u, const glm::vec3 &v, uint32_t material) :
+			Primitive(origin, material), u(u), v(v)
 		{
 			box = calculate_bounding_box();
 			n = calculateNormal();
@@ -132,12 +133,25 @@ namespace traceur {
 
 			hit.primitive = this;
 			hit.distance = t;
-			hit.position = p;
-			hit.normal = n;
+			hit.u = a;
+			hit.v = b;
 
 			return true;
 		}
 
+		/**
+		 * Compute the position and normal of a {@link Hit} with this
+		 * triangle.
+		 *
+		 * @param[in] ray The ray that has hit this triangle.
+		 * @param[in] hit The hit to complete.
+		 */
+		inline virtual void finalize(const traceur::Ray &ray, traceur::Hit &hit) const final
+		{
+			hit.position = ray.origin + hit.distance * ray.direction;
+			hit.normal = n;
+		}
+
 		/**
 		 * Accept a {@link SceneGraphVisitor} instance to visit this node in
 		 * the graph of the scene.
@@ -160,12 +174,11 @@ namespace traceur {
 		}
 
 		/**
-		 * Return the bounding {@link Box} which encapsulates the whole
-		 * primitive.
+		 * Return the bounding box which encapsulates the whole primitive.
 		 *
-		 * @return The bounding {@link Box} instance.
+		 * @return The bounding {@link AABB} instance.
 		 */
-		virtual const Box & bounding_box() const final
+		virtual const traceur::AABB & bounding_box() const final
 		{
 			return box;
 		}
@@ -173,10 +186,9 @@ namespace traceur {
 		/**
 		 * Calculate the bounding box of this primitive.
 		 *
-		 * @param[in] The material of the bounding box.
-		 * @return The bounding {@link Box} of this primitive.
+		 * @return The bounding {@link AABB} of this primitive.
 		 */
-		Box calculate_bounding_box() const
+		traceur::AABB calculate_bounding_box() const
 		{
 			float infinity = std::numeric_limits<float>::infinity();
 			glm::vec3 min(infinity), max(-infinity);
@@ -185,7 +197,196 @@ namespace traceur {
 				min = glm::min(min, vertex);
 				max = glm::max(max, vertex);
 			}
-			return traceur::Box(min, max, material);
+			return traceur::AABB(min, max);
+		}
+	};
+
+	/**
+	 * A precomputed affine transform of a {@link Triangle}, which maps the
+	 * triangle onto the unit triangle (Baldwin and Weber). Intersecting a
+	 * ray with the transformed triangle takes a few multiply-adds and a
+	 * single division, at the cost of twelve floats per triangle.
+	 */
+	class TriangleTransform {
+		/**
+		 * The rows of the transform, of which the first two compute the
+		 * barycentric coordinates of a point and the last one its distance
+		 * to the plane of the triangle along the normal.
+		 */
+		glm::vec4 rows[3];
+
+		/**
+		 * Allow a {@link TrianglePacket} to access our privates.
+		 */
+		friend class TrianglePacket;
+	public:
+		/**
+		 * Construct a {@link TriangleTransform} instance.
+		 *
+		 * @param[in] triangle The triangle to compute the transform of.
+		 */
+		TriangleTransform(const traceur::Triangle &triangle)
+		{
+			auto &u = triangle.u;
+			auto &v = triangle.v;
+			auto n = glm::cross(u, v);
+
+			/* The rows of the inverse of the matrix [u v n] */
+			float det = glm::dot(n, n);
+			glm::vec3 x = glm::cross(v, n) / det;
+			glm::vec3 y = glm::cross(n, u) / det;
+			glm::vec3 z = n / det;
+
+			rows[0] = glm::vec4(x, -glm::dot(x, triangle.origin));
+			rows[1] = glm::vec4(y, -glm::dot(y, triangle.origin));
+			rows[2] = glm::vec4(z, -glm::dot(z, triangle.origin));
+		}
+
+		/**
+		 * Determine whether the given ray intersects the transformed
+		 * triangle.
+		 *
+		 * Points on the edges of the triangle are included, so a ray that
+		 * hits an edge shared by two triangles hits at least one of them.
+		 *
+		 * @param[in] triangle The triangle of which this is the transform.
+		 * @param[in] ray The ray to intersect with the triangle.
+		 * @param[in] hit The intersection with the triangle if it exists.
+		 * @return <code>true</code> if the triangle intersects the ray,
+		 * otherwise <code>false</code>.
+		 */
+		inline bool intersect(const traceur::Triangle &triangle,
+							  const traceur::Ray &ray,
+							  traceur::Hit &hit) const
+		{
+			/* Transform the ray into the space of the unit triangle */
+			float oz = transform(rows[2], ray.origin) + rows[2].w;
+			float dz = transform(rows[2], ray.direction);
+			float t = -oz / dz;
+
+			/* Reject hits behind the ray and rays parallel to the plane,
+			 * for which t is not a number */
+			if (!(t >= 0)) {
+				return false;
+			}
+
+			float a = transform(rows[0], ray.origin) + rows[0].w + t * transform(rows[0], ray.direction);
+			float b = transform(rows[1], ray.origin) + rows[1].w + t * transform(rows[1], ray.direction);
+
+			if (!(a >= 0 && b >= 0 && a + b <= 1)) {
+				return false;
+			}
+
+			hit.primitive = &triangle;
+			hit.distance = t;
+			hit.u = a;
+			hit.v = b;
+			return true;
+		}
+	private:
+		/**
+		 * Apply the linear part of a row of the transform to a vector.
+		 *
+		 * @param[in] row The row of the transform.
+		 * @param[in] vector The vector to transform.
+		 * @return The transformed component of the vector.
+		 */
+		static inline float transform(const glm::vec4 &row, const glm::vec3 &vector)
+		{
+			return row.x * vector.x + row.y * vector.y + row.z * vector.z;
+		}
+	};
+
+	/**
+	 * The transforms of four triangles in structure-of-arrays layout, which
+	 * are intersected with a ray at once using SIMD instructions.
+	 */
+	class TrianglePacket {
+		/**
+		 * The components of the rows of the transforms, of which each lane
+		 * belongs to another triangle.
+		 */
+		traceur::Float4 rows[3][4];
+	public:
+		/**
+		 * The number of triangles in a packet.
+		 */
+		static const int Width = 4;
+
+		/**
+		 * Construct a {@link TrianglePacket} instance.
+		 *
+		 * @param[in] transforms The transforms of the triangles in the
+		 * packet.
+		 * @param[in] count The number of triangles in the packet. The
+		 * remaining lanes never intersect a ray.
+		 */
+		TrianglePacket(const traceur::TriangleTransform *transforms, int count)
+		{
+			for (int i = 0; i < 3; i++) {
+				for (int j = 0; j < 4; j++) {
+					float lanes[Width];
+					for (int k = 0; k < Width; k++) {
+						/* A lane without triangle has a plane that never
+						 * lies in front of the ray */
+						lanes[k] = k < count ? transforms[k].rows[i][j] : (i == 2 && j == 3 ? 1.f : 0.f);
+					}
+					rows[i][j] = traceur::Float4(lanes[0], lanes[1], lanes[2], lanes[3]);
+				}
+			}
+		}
+
+		/**
+		 * Intersect the given ray with the triangles in this packet, which
+		 * gives the same results as
+		 * {@link TriangleTransform#intersect(const Triangle &, const Ray &, Hit &)}
+		 * for each triangle.
+		 *
+		 * @param[in] ray The ray to intersect with the triangles.
+		 * @param[out] t The distances to the triangles.
+		 * @param[out] a The first barycentric coordinates of the hits.
+		 * @param[out] b The second barycentric coordinates of the hits.
+		 * @return A bit mask of the triangles that intersect the ray.
+		 */
+		inline int intersect(const traceur::AlignedRay &ray,
+							 traceur::Float4 &t,
+							 traceur::Float4 &a,
+							 traceur::Float4 &b) const
+		{
+			auto zero = traceur::Float4::broadcast(0.f);
+			auto one = traceur::Float4::broadcast(1.f);
+
+			/* Transform the ray into the space of the unit triangles */
+			auto oz = transform(rows[2], ray.ox, ray.oy, ray.oz) + rows[2][3];
+			auto dz = transform(rows[2], ray.dx, ray.dy, ray.dz);
+			t = -oz / dz;
+
+			int mask = greaterEqual(t, zero);
+			if (!mask) {
+				return 0;
+			}
+
+			a = transform(rows[0], ray.ox, ray.oy, ray.oz) + rows[0][3] + t * transform(rows[0], ray.dx, ray.dy, ray.dz);
+			b = transform(rows[1], ray.ox, ray.oy, ray.oz) + rows[1][3] + t * transform(rows[1], ray.dx, ray.dy, ray.dz);
+
+			return mask & greaterEqual(a, zero) & greaterEqual(b, zero) & lessEqual(a + b, one);
+		}
+	private:
+		/**
+		 * Apply the linear part of a row of the transforms to a vector.
+		 *
+		 * @param[in] row The components of the row of the transforms.
+		 * @param[in] x The first components of the vectors.
+		 * @param[in] y The second components of the vectors.
+		 * @param[in] z The third components of the vectors.
+		 * @return The transformed components of the vectors.
+		 */
+		static inline traceur::Float4 transform(const traceur::Float4 *row,
+												const traceur::Float4 &x,
+												const traceur::Float4 &y,
+												const traceur::Float4 &z)
+		{
+			return row[0] * x + row[1] * y + row[2] * z;
 		}
 	};
 }
@@ -24,14 +24,29 @@
 #ifndef TRACEUR_CORE_SCENE_SCENE_H
 #define TRACEUR_CORE_SCENE_SCENE_H
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
 #include <traceur/core/scene/graph/graph.hpp>
+#include <traceur/core/scene/features.hpp>
+#include <traceur/core/material/material.hpp>
 #include <traceur/core/lightning/light.hpp>
 #include <traceur/core/scene/camera.hpp>
 
 namespace traceur {
+	/**
+	 * Return a new scene generation, which is unique within the process.
+	 *
+	 * @return The generation.
+	 */
+	inline uint64_t next_scene_generation()
+	{
+		static std::atomic<uint64_t> generation(0);
+		return ++generation;
+	}
+
 	/**
 	 * This class represents a scene which consists of primitives and lights,
 	 * which can be rendered by a {@link Kernel} instance.
@@ -43,15 +58,34 @@ namespace traceur {
 		 */
 		std::shared_ptr<traceur::SceneGraph> graph;
 
+		/**
+		 * The table of materials in the scene, which is indexed by the
+		 * material ids of the primitives.
+		 */
+		std::vector<traceur::Material> materials;
+
 		/**
 		 * The lights in the scene.
 		 */
 		std::vector<traceur::Light> lights;
 
+		/**
+		 * The features used by the geometry of the scene.
+		 */
+		traceur::SceneFeatures features;
+
+		/**
+		 * The generation of the scene, which identifies its contents to the
+		 * caches of the kernels. Every scene receives a new generation when
+		 * it is constructed, so a cache never mistakes a new scene for a
+		 * previous one.
+		 */
+		uint64_t generation;
+
 		/**
 		 * Construct a {@link Scene} instance.
 		 */
-		Scene() {}
+		Scene() : generation(traceur::next_scene_generation()) {}
 
 		/**
 		 * Construct a {@link Scene} instance.
@@ -59,7 +93,7 @@ namespace traceur {
 		 * @param[in] graph The graph of the scene.
 		 */
 		Scene(std::shared_ptr<traceur::SceneGraph> graph) :
-			graph(graph) {}
+			graph(graph), generation(traceur::next_scene_generation()) {}
 
 		/**
 		 * Construct a {@link Scene} instance.
@@ -68,7 +102,17 @@ namespace traceur {
 		 * @param[in] lights The lights in the scene.
 		 */
 		Scene(std::shared_ptr<traceur::SceneGraph> graph, std::vector<traceur::Light> &lights) :
-			graph(graph), lights(lights) {}
+			graph(graph), lights(lights), generation(traceur::next_scene_generation()) {}
+
+		/**
+		 * Assign a new generation to the scene, which must be done after its
+		 * graph or materials have been changed so that the kernels discard
+		 * the data they have cached for the scene.
+		 */
+		inline void invalidate()
+		{
+			generation = traceur::next_scene_generation();
+		}
 	};
 }
 
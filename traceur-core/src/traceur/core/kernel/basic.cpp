@@ -24,130 +24,186 @@
 
 #include <traceur/core/kernel/basic.hpp>
 #include <traceur/core/scene/primitive/primitive.hpp>
+#include <traceur/core/scene/graph/dispatch.hpp>
+#include <traceur/core/sampler/sobol.hpp>
+#include <algorithm>
+#include <cassert>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <type_traits>
 #include <glm/gtx/string_cast.hpp>
 
+traceur::BasicKernel::BasicKernel() :
+	BasicKernel(std::make_shared<traceur::SobolSampler>(), 50) {}
+
+traceur::BasicKernel::BasicKernel(std::shared_ptr<traceur::Sampler> sampler, int lightSamples, unsigned features) :
+	sampler(sampler), lightSamples(lightSamples), sampledLights(4),
+	pixelOrder(traceur::SpaceFillingCurve::Scanline), channels(0), m_features(features & traceur::SceneFeatures::All),
+	m_lightGeneration(0)
+{
+	static const Shader *tables[] = {
+		shaders<0>(), shaders<1>(), shaders<2>(), shaders<3>(),
+		shaders<4>(), shaders<5>(), shaders<6>(), shaders<7>(),
+	};
+	m_shaders = tables[m_features];
+	assert(lightSamples >= 1);
+}
+
+template<unsigned Features>
+const traceur::BasicKernel::Shader * traceur::BasicKernel::shaders()
+{
+	// The shading function of each illumination model, which are
+	// instantiated once so that every model is shaded without branching on
+	// the features of other models
+	static const Shader table[traceur::IlluminationModels] = {
+		&traceur::BasicKernel::shadeModel<0, Features>,
+		&traceur::BasicKernel::shadeModel<1, Features>,
+		&traceur::BasicKernel::shadeModel<2, Features>,
+		&traceur::BasicKernel::shadeModel<3, Features>,
+		&traceur::BasicKernel::shadeModel<4, Features>,
+		&traceur::BasicKernel::shadeModel<5, Features>,
+		&traceur::BasicKernel::shadeModel<6, Features>,
+		&traceur::BasicKernel::shadeModel<7, Features>,
+		&traceur::BasicKernel::shadeModel<8, Features>,
+		&traceur::BasicKernel::shadeModel<9, Features>,
+	};
+	return table;
+}
+
 traceur::Pixel traceur::BasicKernel::shade(const traceur::TracingContext &context,
 										   int depth) const
 {
-	auto result = traceur::Pixel(0, 0, 0);
-    float ambientLight = 0.2f;
-    int maxDepth = 8;
-
-	auto &material = context.hit.primitive->material;
-
-    if (material->illuminationModel > 0 && material->illuminationModel < 10) {
-        // Ambient light
-        result = material->ambient * ambientLight;
-
-        // Setting up loop-over variables
-        glm::vec3 diffuseReflectanceMultiples = glm::vec3(0,0,0);
-        glm::vec3 specularReflectanceMultiples = glm::vec3(0,0,0);
-
-        // For each light
-        for (auto &light : context.scene.lights) {
-            auto lightDir = glm::normalize(light - context.hit.position);
-
-            // Fetch light level
-            float lightCastIntensity = lightLevel(light, context.hit, context.scene);
-
-            // Give lightLevel as raw output for the first light:
-            // return glm::vec3(1,1,1) * lightCastIntensity;
-
-            // Diffuse illumination model using Lambertian shading
-            diffuseReflectanceMultiples += diffuse(context, lightDir) * lightCastIntensity;
-
-            // Specular illumination model
-            switch (material->illuminationModel) {
-                case 2:
-                case 3:
-                case 4:
-                case 6:
-                case 8:
-                case 9:
-                    // Specular * ( {SUM specular() } ) : 2
-                    // Specular * ( {SUM specular() } + reflection() ) : 3, 4, 6, 8, 9
-                    specularReflectanceMultiples += specular(context, lightDir) * lightCastIntensity;
-                    break;
-                case 5:
-                case 7:
-                    // Specular * ( {SUM specular() * fresnelLight()} + fresnelFinal() ) : 5, 7
-                    break;
-                default:
-                    break;
-            }
+	// Fetch the material only once per hit
+	auto &material = context.scene.materials[context.hit.primitive->material];
+	int model = material.illuminationModel;
 
-        }
+	// Unknown illumination models output their color directly
+	if (model < 0 || model >= traceur::IlluminationModels) {
+		model = 0;
+	}
 
-        // Finalising loop-over variables
-        switch (material->illuminationModel) {
-            case 3:
-            case 4:
-            case 6:
-            case 8:
-            case 9:
-                // Specular * ( {SUM specular() } + reflection() ) : 3, 4, 6, 8, 9
-                if (depth < maxDepth) {
-                    specularReflectanceMultiples += reflection(context, depth + 1);
-                }
-                break;
-            case 5:
-            case 7:
-                // Specular * ( {SUM specular() * fresnelLight()} + fresnelFinal() ) : 5, 7
-
-                // Todo: replace this fallback! This is not Fresnel reflection but normal reflection
-                if (depth < maxDepth) {
-                    specularReflectanceMultiples += reflection(context, depth + 1);
-                }
-                break;
-            default:
-                break;
-        }
+	// Return final value
+	return glm::clamp((this->*m_shaders[model])(context, material, depth), 0.f, 1.f);
+}
 
-        // Multiplying loop-over variables with multipliers
-        diffuseReflectanceMultiples *= material->diffuse;
-        specularReflectanceMultiples *= material->specular;
-
-        // Add finalised values to result
-        result += diffuseReflectanceMultiples;
-        result += specularReflectanceMultiples;
-
-        // Handling transparent objects
-        switch (material->illuminationModel) {
-            case 4:
-                // Transparency mode
-                if (depth < maxDepth) {
-                    result *= 1.f - material->transparency;
-                    result += material->transparency * transparent(context, depth + 1);
-                }
-                break;
-            case 6:
-                // Basic refraction
-                // (1.0 - mat.specular) mat.transmissionFilter * refraction() : 6
-                if (depth < maxDepth) {
-                    result += (1.f - material->specular) * material->transmissionFilter * refraction(context, depth + 1);
-                }
-                break;
-            case 7:
-                // Fresnel refraction
-                // (1.0 - Kx)Ft (N*V,(1.0-mat.specular),mat.shininess)mat.transmissionFilter * refraction() : 7
-
-                // Todo: replace this fallback! This is not Fresnel refraction but normal refraction
-                if (depth < maxDepth) {
-                    result += (1.f - material->specular) * material->transmissionFilter * refraction(context, depth + 1);
-                }
-                break;
-            default:
-                break;
-        }
+template<int Model, unsigned Features>
+traceur::Pixel traceur::BasicKernel::shadeModel(const traceur::TracingContext &context,
+												const traceur::Material &material,
+												int depth) const
+{
+	// The features of the illumination model that are used by the scene
+	using Traits = traceur::IlluminationModel<Model>;
+	constexpr bool reflects = Traits::reflection && (Features & traceur::SceneFeatures::Reflection);
+	constexpr bool transmits = Traits::transparency && (Features & traceur::SceneFeatures::Transmission);
+	constexpr bool refracts = Traits::refraction && (Features & traceur::SceneFeatures::Transmission);
+	constexpr bool lightSampling = (Features & traceur::SceneFeatures::LightSampling) != 0;
+	float ambientLight = 0.2f;
+	int maxDepth = 8;
+
+	if (!Traits::lit) {
+		// Direct color output on illuminationModel 0
+		return material.diffuse;
+	}
 
-    } else {
-        // Direct color output on illuminationModel 0
-        result = material->diffuse;
-    }
+	// Ambient light
+	auto result = material.ambient * ambientLight;
+
+	// Setting up loop-over variables
+	glm::vec3 diffuseReflectanceMultiples = glm::vec3(0,0,0);
+	glm::vec3 specularReflectanceMultiples = glm::vec3(0,0,0);
+
+	// Evaluate every light, or importance sample a few lights from the
+	// light tree if the scene contains many lights
+	auto tree = context.state.lights.get();
+	auto &samples = context.state.samples;
+	bool sampling = lightSampling && tree && !tree->empty();
+	int count = sampling ? sampledLights : static_cast<int>(context.scene.lights.size());
+	uint32_t dimension = sampling ? samples.reserve(1) : 0;
+
+	// The weights of the contributions of a light, of which the specular
+	// contribution does not depend on the direction of the light
+	float diffuseWeight = traceur::luminance(material.diffuse);
+	float specularWeight = Traits::specular ? traceur::luminance(material.specular) : 0.f;
+
+	// For each light
+	for (int j = 0; j < count; j++) {
+		size_t i = static_cast<size_t>(j);
+		float weight = 1.f;
+
+		if (sampling) {
+			float pdf;
+			uint32_t index = samples.index() * sampledLights + j;
+			int sampled = tree->sample(context.hit.position, context.hit.normal, diffuseWeight,
+									   specularWeight, samples(index, dimension), pdf);
+			if (sampled < 0) {
+				// No light can contribute to this point
+				break;
+			}
+			i = static_cast<size_t>(sampled);
+			weight = 1.f / (pdf * sampledLights);
+		}
+
+		auto &light = context.scene.lights[i];
+		auto lightDir = glm::normalize(light - context.hit.position);
+
+		// Fetch light level
+		float lightCastIntensity = (this->*context.state.lightLevel)(context, i) * weight;
+
+		// Give lightLevel as raw output for the first light:
+		// return glm::vec3(1,1,1) * lightCastIntensity;
+
+		// Diffuse illumination model using Lambertian shading
+		diffuseReflectanceMultiples += diffuse(context, lightDir) * lightCastIntensity;
+
+		// Specular illumination model
+		// Specular * ( {SUM specular() } ) : 2
+		// Specular * ( {SUM specular() } + reflection() ) : 3, 4, 6, 8, 9
+		if (Traits::specular) {
+			specularReflectanceMultiples += specular(context, lightDir) * lightCastIntensity;
+		}
+	}
+
+	// Indirect diffuse illumination by caustics
+	if (context.state.caustics) {
+		diffuseReflectanceMultiples += context.state.caustics->irradiance(context.hit.position, context.hit.normal);
+	}
+
+	// Finalising loop-over variables
+	// Specular * ( {SUM specular() } + reflection() ) : 3, 4, 6, 8, 9
+	// Specular * ( {SUM specular() * fresnelLight()} + fresnelFinal() ) : 5, 7
+	// Todo: replace the fallback of 5 and 7! This is not Fresnel reflection
+	// but normal reflection
+	if (reflects && depth < maxDepth) {
+		specularReflectanceMultiples += reflection(context, depth + 1);
+	}
+
+	// Multiplying loop-over variables with multipliers
+	diffuseReflectanceMultiples *= material.diffuse;
+	specularReflectanceMultiples *= material.specular;
 
-    // Return final value
-    return glm::clamp(result, 0.f, 1.f);
+	// Add finalised values to result
+	result += diffuseReflectanceMultiples;
+	result += specularReflectanceMultiples;
+
+	// Handling transparent objects
+	if (transmits && depth < maxDepth) {
+		// Transparency mode
+		result *= 1.f - material.transparency;
+		result += material.transparency * transparent(context, depth + 1);
+	}
+
+	// Basic refraction
+	// (1.0 - mat.specular) mat.transmissionFilter * refraction() : 6
+	// Fresnel refraction
+	// (1.0 - Kx)Ft (N*V,(1.0-mat.specular),mat.shininess)mat.transmissionFilter * refraction() : 7
+	// Todo: replace the fallback of 7! This is not Fresnel refraction but
+	// normal refraction
+	if (refracts && depth < maxDepth) {
+		result += (1.f - material.specular) * material.transmissionFilter * refraction(context, depth + 1);
+	}
+
+	return result;
 }
 
 traceur::Pixel traceur::BasicKernel::diffuse(const traceur::TracingContext &context,
@@ -158,17 +214,17 @@ traceur::Pixel traceur::BasicKernel::diffuse(const traceur::TracingContext &cont
 }
 
 traceur::Pixel traceur::BasicKernel::specular(const traceur::TracingContext &context,
-											  const glm::vec3 &lightDir) const
+											  const glm::vec3 &) const
 {
 	auto &ray = context.ray;
 	auto &hit = context.hit;
-	auto &material = hit.primitive->material;
+	auto &material = context.scene.materials[hit.primitive->material];
 
 	auto viewDir = glm::normalize(context.ray.origin - hit.position);
 	auto reflection = glm::reflect(context.ray.direction, hit.normal);
 
 	float angle = std::max(0.f, glm::dot(viewDir, reflection));
-	float intensity = powf(angle, material->shininess);
+	float intensity = powf(angle, material.shininess);
 
 	return intensity * glm::vec3(1,1,1);
 }
@@ -186,7 +242,7 @@ traceur::Pixel traceur::BasicKernel::reflection(const traceur::TracingContext &c
     glm::vec3 newOrigin = context.hit.position + globalOffset * newDirection;
 
     auto next = traceur::Ray(newOrigin, newDirection);
-    return trace(context.scene, context.camera, next, depth);
+    return (this->*context.state.trace)(context.scene, context.camera, next, depth, context.state);
 }
 
 traceur::Pixel traceur::BasicKernel::refraction(const traceur::TracingContext &context,
@@ -196,13 +252,15 @@ traceur::Pixel traceur::BasicKernel::refraction(const traceur::TracingContext &c
     float sourceDestRefraction;
     glm::vec3 refractionNormal;
 
+    auto &material = context.scene.materials[context.hit.primitive->material];
+
     if(glm::dot(context.hit.normal, context.ray.direction) < 0) {
         // enter material
-        sourceDestRefraction = 1.f / context.hit.primitive->material->opticalDensity;
+        sourceDestRefraction = 1.f / material.opticalDensity;
         refractionNormal = context.hit.normal;
     } else {
         // exit material
-        sourceDestRefraction = context.hit.primitive->material->opticalDensity / 1.f;
+        sourceDestRefraction = material.opticalDensity / 1.f;
         refractionNormal = - context.hit.normal;
     }
 
@@ -217,7 +275,7 @@ traceur::Pixel traceur::BasicKernel::refraction(const traceur::TracingContext &c
     glm::vec3 newOrigin = context.hit.position + globalOffset * newDirection;
 
     auto next = traceur::Ray(newOrigin, newDirection);
-    return trace(context.scene, context.camera, next, depth);
+    return (this->*context.state.trace)(context.scene, context.camera, next, depth, context.state);
 
 }
 
@@ -227,7 +285,7 @@ traceur::Pixel traceur::BasicKernel::transparent(const traceur::TracingContext &
     glm::vec3 newDirection = context.ray.direction;
     glm::vec3 newOrigin = context.hit.position + globalOffset * newDirection;
     auto next = traceur::Ray(newOrigin, newDirection);
-    return trace(context.scene, context.camera, next, depth);
+    return (this->*context.state.trace)(context.scene, context.camera, next, depth, context.state);
 }
 
 /*
@@ -235,6 +293,13 @@ traceur::Pixel traceur::BasicKernel::transparent(const traceur::TracingContext &
 */
 std::unique_ptr<traceur::Film> traceur::BasicKernel::render(const traceur::Scene &scene,
 															const traceur::Camera &camera) const
+{
+	return render(scene, camera, traceur::singlePass);
+}
+
+std::unique_ptr<traceur::Film> traceur::BasicKernel::render(const traceur::Scene &scene,
+															const traceur::Camera &camera,
+															int pass) const
 {
 	// the default camera viewport is a vec4 in the following format;
 	// ivec4(0, 0, viewWidth, viewHeight)
@@ -247,7 +312,7 @@ std::unique_ptr<traceur::Film> traceur::BasicKernel::render(const traceur::Scene
 	// film is a pointer, so pass the reference using the *
 	// call the render function with offset(0,0), the multithreading
 	// kernel will pass different values here
-	render(scene, camera, *film, glm::ivec2());
+	render(scene, camera, *film, glm::ivec2(), pass);
 
 	// return the film and move the responsibility of deallocation
 	// to the caller using std::move
@@ -261,6 +326,49 @@ void traceur::BasicKernel::render(const traceur::Scene &scene,
 								  const traceur::Camera &camera,
 								  traceur::Film &film,
 								  const glm::ivec2 &offset) const
+{
+	render(scene, camera, film, offset, traceur::singlePass);
+}
+
+void traceur::BasicKernel::render(const traceur::Scene &scene,
+								  const traceur::Camera &camera,
+								  traceur::Film &film,
+								  const glm::ivec2 &offset,
+								  int pass) const
+{
+	// Discard the cached visibility if the scene has changed since the
+	// previous render
+	if (visibilityCache) {
+		visibilityCache->attach(scene);
+	}
+
+	// Select the instantiation of the kernel for the type of the graph that
+	// has been built for the scene. The job then binds the tracer of that
+	// instantiation for the active instruction set, in which the traversal
+	// of the graph is inlined
+	traceur::visit_graph(*scene.graph, [&](const auto &graph) {
+		using Graph = typename std::decay<decltype(graph)>::type;
+		renderGraph<Graph>(scene, camera, film, offset, pass);
+	});
+}
+
+std::shared_ptr<const traceur::LightTree> traceur::BasicKernel::lightTree(const traceur::Scene &scene) const
+{
+	std::lock_guard<std::mutex> lock(m_lightMutex);
+	if (!m_lightTree || m_lightGeneration != scene.generation || m_treeLights != scene.lights) {
+		m_lightTree = std::make_shared<const traceur::LightTree>(scene.lights);
+		m_lightGeneration = scene.generation;
+		m_treeLights = scene.lights;
+	}
+	return m_lightTree;
+}
+
+template<class Graph>
+void traceur::BasicKernel::renderGraph(const traceur::Scene &scene,
+									   const traceur::Camera &camera,
+									   traceur::Film &film,
+									   const glm::ivec2 &offset,
+									   int pass) const
 {
 	/* Notify observers about render */
 	for (auto &observer : observers) {
@@ -268,25 +376,123 @@ void traceur::BasicKernel::render(const traceur::Scene &scene,
 		observer->partitionStarted(*this, 0, film, offset);
 	}
 
-	traceur::Ray ray;
+	traceur::RenderState state(scene.lights.size(), *sampler);
+	bind<Graph>(state);
+	if ((m_features & traceur::SceneFeatures::LightSampling) && sampledLights > 0
+		&& scene.lights.size() > static_cast<size_t>(sampledLights)) {
+		state.lights = lightTree(scene);
+	}
+	prepare(scene, state);
+	traceur::RayGenerator rays(camera);
+	std::vector<traceur::Ray> row(film.width);
 	traceur::Pixel pixel;
 
-	// loop through all pixels on the film
-	// for performance, loop over y first
-	for (int y = 0; y < film.height; y++) {
-		for (int x = 0; x < film.width; x++) {
-			// create a ray from camera to (x + offsetX, y + offsetY)
-			ray = camera.rayFrom(glm::ivec2(x, y) + offset);
-
-			// trace the ray through the scene, this returns a Pixel.
-			// a Pixel is equivalent to a ivec3, containing the color
-			// of the pixel as R,G,B values. The location of the
-			// intersection point is NOT known!
-			pixel = trace(scene, camera, ray, 0);
-
-			// write the pixel color to the array
-			film(x, y) = pixel;
+	// the channels besides the color are only written into direct films
+	auto direct = dynamic_cast<traceur::DirectFilm *>(&film);
+	unsigned planes = direct ? channels & traceur::Channels::All : 0;
+	int count;
+
+	// the attributes of the primary rays of a pixel are gathered and
+	// written into the channels of the film
+	traceur::AuxiliaryPixel attributes;
+	if (planes) {
+		direct->enable(planes);
+	}
+	if (planes & ~traceur::Channels::SampleCount) {
+		state.auxiliary = &attributes;
+	}
+	auto recordPixel = [&](int x, int y, int samples) {
+		if (!planes) {
+			return;
+		}
+
+		auto pos = glm::ivec2(x, y);
+		float weight = 1.f / static_cast<float>(std::max(1, samples));
+		if (planes & traceur::Channels::Depth) {
+			direct->channel<traceur::Channels::Depth>(pos) = attributes.depth * weight;
+		}
+		if (planes & traceur::Channels::Normal) {
+			direct->channel<traceur::Channels::Normal>(pos) = attributes.normal * weight;
+		}
+		if (planes & traceur::Channels::Albedo) {
+			direct->channel<traceur::Channels::Albedo>(pos) = attributes.albedo * weight;
+		}
+		if (planes & traceur::Channels::PrimitiveId) {
+			direct->channel<traceur::Channels::PrimitiveId>(pos) = attributes.primitive;
+		}
+		if (planes & traceur::Channels::MaterialId) {
+			direct->channel<traceur::Channels::MaterialId>(pos) = attributes.material;
+		}
+		if (planes & traceur::Channels::SampleCount) {
+			direct->channel<traceur::Channels::SampleCount>(pos) =
+				static_cast<uint16_t>(std::min<int>(samples, std::numeric_limits<uint16_t>::max()));
 		}
+		attributes = traceur::AuxiliaryPixel();
+	};
+
+	// every pass of a progressive render job is jittered and takes its own
+	// sample indices, so the mean of the passes does not favour the corner
+	// of the pixels
+	bool supersampling = antiAliasing.enabled() || pass != traceur::singlePass;
+	uint32_t first = static_cast<uint32_t>(std::max(0, pass) * std::max(1, antiAliasing.maxSamples));
+
+	if (supersampling) {
+		state.rendered.assign(static_cast<size_t>(film.width) * static_cast<size_t>(film.height), false);
+	}
+
+	// render a single pixel of the film, of which the primary ray is only
+	// used without supersampling
+	auto renderPixel = [&](int x, int y, const traceur::Ray &ray) {
+		if (supersampling) {
+			film(x, y) = supersample<Graph>(scene, camera, rays, film, glm::ivec2(x, y), offset, first, state, count);
+			recordPixel(x, y, count);
+			state.rendered[static_cast<size_t>(y) * static_cast<size_t>(film.width) + static_cast<size_t>(x)] = true;
+			return;
+		}
+
+		state.samples.start(glm::ivec2(x, y) + offset);
+		state.statistics.pixels++;
+		state.statistics.primarySamples++;
+
+		// trace the ray through the scene, this returns a Pixel.
+		// a Pixel is equivalent to a ivec3, containing the color
+		// of the pixel as R,G,B values. The location of the
+		// intersection point is NOT known!
+		pixel = (this->*state.trace)(scene, camera, ray, 0, state);
+
+		// write the pixel color to the array
+		film(x, y) = pixel;
+		recordPixel(x, y, 1);
+	};
+
+	if (pixelOrder != traceur::SpaceFillingCurve::Scanline) {
+		// follow the curve through the partition, so consecutive rays touch
+		// the same parts of the scene graph
+		traceur::Ray ray;
+		for (auto &pos : traceur::curve_points(pixelOrder, film.width, film.height)) {
+			if (!supersampling) {
+				ray = rays(glm::vec2(pos + offset));
+			}
+			renderPixel(pos.x, pos.y, ray);
+		}
+	} else {
+		// loop through all pixels on the film
+		// for performance, loop over y first
+		for (int y = 0; y < film.height; y++) {
+			if (!supersampling) {
+				rays.row(glm::vec2(offset.x, offset.y + y), film.width, row.data());
+			}
+
+			for (int x = 0; x < film.width; x++) {
+				renderPixel(x, y, row[x]);
+			}
+		}
+	}
+
+	/* Merge the statistics of this render job */
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		m_statistics += state.statistics;
 	}
 
 	/* Notify observers about finish */
@@ -304,56 +510,179 @@ void traceur::BasicKernel::render(const traceur::Scene &scene,
  *
  * An empty pixel (0,0,0) is returned when there is no intersection.
 */
+template<class Graph>
 traceur::Pixel traceur::BasicKernel::trace(const traceur::Scene &scene,
 										   const traceur::Camera &camera,
 										   const traceur::Ray &ray,
-										   int depth) const
+										   int depth,
+										   traceur::RenderState &state) const
 {
 	traceur::Hit hit;
 	// Find the intersection of ray with the nearest object.
 	// The nearest object is stored in hit. The function intersect
 	// returns true if there is an intersection, false otherwise.
-	if (scene.graph->intersect(ray, hit)) {
+	if (static_cast<const Graph &>(*scene.graph).intersect(ray, hit)) {
+		if (depth == 0) {
+			state.record(scene.materials[hit.primitive->material].diffuse, ray, hit);
+		}
+
 		// hit.primitive returns the type, so for example a triangle,
 		// sphere, etc... This object has a material. The material
 		// contains the diffuse, Kd, Ks and shininess values.
-		return shade(traceur::TracingContext(scene, camera, ray, hit), depth);
+		return shade(traceur::TracingContext(scene, camera, ray, hit, state), depth);
 	}
 
 	// return an empty pixel (0,0,0)
 	return traceur::Pixel();
 }
 
-float traceur::BasicKernel::lightLevel(const traceur::Light &lightSource, const traceur::Hit &hit, const traceur::Scene &scene) const {
-    float resLevel = 0;
+/*
+ * Adaptive supersampling of a single pixel.
+ *
+ * The first two dimensions of every sample are used to jitter the ray within
+ * the pixel, so each sample index of the pixel receives its own point of the
+ * (low-discrepancy) sequence.
+ */
+template<class Graph>
+traceur::Pixel traceur::BasicKernel::supersample(const traceur::Scene &scene,
+												 const traceur::Camera &camera,
+												 const traceur::RayGenerator &rays,
+												 const traceur::Film &film,
+												 const glm::ivec2 &pos,
+												 const glm::ivec2 &offset,
+												 uint32_t first,
+												 traceur::RenderState &state,
+												 int &count) const
+{
+	auto pixel = pos + offset;
+	auto sum = traceur::Pixel(0, 0, 0);
+	float luminanceSum = 0;
+	float luminanceSquaredSum = 0;
+	int minSamples = std::max(1, std::min(antiAliasing.minSamples, antiAliasing.maxSamples));
+	int n = 0;
+
+	auto sample = [&](int samples) {
+		for (int end = n + samples; n < end; n++) {
+			uint32_t index = first + static_cast<uint32_t>(n);
+			state.samples.start(pixel, index);
+			uint32_t dimension = state.samples.reserve(2);
+			glm::vec2 jitter(state.samples(index, dimension), state.samples(index, dimension + 1));
+
+			auto color = (this->*state.trace)(scene, camera, rays(glm::vec2(pixel) + jitter), 0, state);
+			float l = traceur::luminance(color);
+			sum += color;
+			luminanceSum += l;
+			luminanceSquaredSum += l * l;
+		}
+	};
+
+	sample(minSamples);
+
+	// Compare with the already rendered neighbours of the pixel
+	bool edge = false;
+	float mean = luminanceSum / n;
+	for (auto neighbour : { glm::ivec2(pos.x - 1, pos.y), glm::ivec2(pos.x, pos.y - 1),
+							glm::ivec2(pos.x + 1, pos.y), glm::ivec2(pos.x, pos.y + 1) }) {
+		if (neighbour.x < 0 || neighbour.y < 0 || neighbour.x >= film.width || neighbour.y >= film.height
+			|| !state.rendered[static_cast<size_t>(neighbour.y) * static_cast<size_t>(film.width)
+							   + static_cast<size_t>(neighbour.x)]) {
+			continue;
+		}
+		float other = traceur::luminance(film(neighbour));
+		float scale = std::max(std::max(mean, other), 0.001f);
+		edge = edge || std::abs(mean - other) / scale > antiAliasing.contrast;
+	}
 
-    srand(1);
-    for (int i = 0; i < 50; i++) {
-        // run X fake light sources
+	// Refine the pixel by doubling the amount of samples until the estimate
+	// has converged or the budget is exhausted
+	while (n < antiAliasing.maxSamples) {
+		if (!edge && n > 1) {
+			mean = luminanceSum / n;
+			float variance = std::max(0.f, (luminanceSquaredSum - n * mean * mean) / (n - 1));
+			if (std::sqrt(variance / n) <= antiAliasing.threshold) {
+				break;
+			}
+		} else if (!edge) {
+			break;
+		}
+		sample(std::min(n, antiAliasing.maxSamples - n));
+	}
+
+	state.statistics.pixels++;
+	state.statistics.primarySamples += n;
+	if (n > minSamples) {
+		state.statistics.refinedPixels++;
+	}
+
+	count = n;
+	return sum / static_cast<float>(n);
+}
+
+template<class Graph>
+float traceur::BasicKernel::lightLevel(const traceur::TracingContext &context, size_t light) const {
+    auto &lightSource = context.scene.lights[light];
+    auto &samples = context.state.samples;
+    uint32_t dimension = samples.reserve(3);
+    float resLevel = 0;
 
-        float LO = -0.05;
-        float HI = 0.05;
-        float offsetX = LO + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (HI - LO)));
-        float offsetY = LO + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (HI - LO)));
-        float offsetZ = LO + static_cast <float> (rand()) / (static_cast <float> (RAND_MAX / (HI - LO)));
+    // interpolate the visibility from nearby points away from shadow edges
+    if (visibilityCache) {
+        context.state.statistics.visibilityQueries++;
+        if (visibilityCache->lookup(context.hit.position, context.hit.normal, light, resLevel)) {
+            context.state.statistics.visibilityCacheHits++;
+            return resLevel;
+        }
+    }
 
-        float level = localLightLevel(glm::vec3(offsetX, offsetY, offsetZ) + lightSource, hit, scene);
-        resLevel += (level / ((float)50));
+    for (int i = 0; i < lightSamples; i++) {
+        // sample a point in the cube around the light
+        uint32_t index = samples.index() * lightSamples + i;
+        glm::vec3 offset = glm::vec3(
+            samples(index, dimension),
+            samples(index, dimension + 1),
+            samples(index, dimension + 2)
+        );
+        offset = (offset * 2.f - 1.f) * lightRadius;
+
+        resLevel += localLightLevel<Graph>(context, lightSource + offset, light);
     }
 
+    resLevel /= lightSamples;
+    if (visibilityCache) {
+        visibilityCache->store(context.hit.position, context.hit.normal, light, resLevel);
+    }
     return resLevel;
 }
 
-float traceur::BasicKernel::localLightLevel(const traceur::Light &lightSource, const traceur::Hit &hit, const traceur::Scene &scene) const{
-    // Can be optimized by having a different intersect method that returns false upon first impact that is closer than the light.
+template<class Graph>
+float traceur::BasicKernel::localLightLevel(const traceur::TracingContext &context,
+                                            const glm::vec3 &lightSource,
+                                            size_t light) const {
+    auto &hit = context.hit;
+    auto &state = context.state;
 
     glm::vec3 origin = lightSource;
     glm::vec3 direction = hit.position - lightSource;
-    direction = glm::normalize(direction);
+    float distance = glm::length(direction);
+    direction = direction / distance;
     traceur::Ray newRay = traceur::Ray(origin, direction);
 
+    state.statistics.shadowRays++;
+
+    // Test the primitive that occluded the previous shadow ray towards this
+    // light first. An intersection that lies clearly in front of the hit is
+    // always classified as shadow by the full test below as well.
+    auto &occluder = state.occluders[light];
+    if (occluder && occluder != hit.primitive) {
+        traceur::Hit occluderHit;
+        if (occluder->intersect(newRay, occluderHit) && occluderHit.distance < distance - occluderEpsilon) {
+            state.statistics.occluderCacheHits++;
+            return 0;
+        }
+    }
+
     traceur::Hit foundHit;
-    if (scene.graph->intersect(newRay, foundHit)) {
+    if (static_cast<const Graph &>(*context.scene.graph).intersect(newRay, foundHit)) {
         // check if foundHit is equal to hit
         glm::vec3 res = foundHit.position - hit.position;
         // epsilon comparison
@@ -363,9 +692,56 @@ float traceur::BasicKernel::localLightLevel(const traceur::Light &lightSource, c
         bool inShadow = !nothingBetween;
 
         if (inShadow) {
+            occluder = foundHit.primitive;
             return 0;
         }
         return 1;
     }
     return 1;
 }
+
+template<class Graph, traceur::ISA I>
+traceur::Pixel traceur::BasicKernel::traceVariant(const traceur::Scene &scene,
+												  const traceur::Camera &camera,
+												  const traceur::Ray &ray,
+												  int depth,
+												  traceur::RenderState &state) const
+{
+	return traceur::Target<I>::invoke([&]() {
+		return trace<Graph>(scene, camera, ray, depth, state);
+	});
+}
+
+template<class Graph, traceur::ISA I>
+float traceur::BasicKernel::lightLevelVariant(const traceur::TracingContext &context, size_t light) const
+{
+	return traceur::Target<I>::invoke([&]() {
+		return lightLevel<Graph>(context, light);
+	});
+}
+
+template<class Graph>
+void traceur::BasicKernel::bind(traceur::RenderState &state) const
+{
+#ifdef TRACEUR_ISA_DISPATCH
+	state.trace = traceur::dispatch<decltype(state.trace)>(
+		&traceur::BasicKernel::traceVariant<Graph, traceur::ISA::Baseline>,
+		&traceur::BasicKernel::traceVariant<Graph, traceur::ISA::SSE42>,
+		&traceur::BasicKernel::traceVariant<Graph, traceur::ISA::AVX2>,
+		&traceur::BasicKernel::traceVariant<Graph, traceur::ISA::AVX512>);
+	state.lightLevel = traceur::dispatch<decltype(state.lightLevel)>(
+		&traceur::BasicKernel::lightLevelVariant<Graph, traceur::ISA::Baseline>,
+		&traceur::BasicKernel::lightLevelVariant<Graph, traceur::ISA::SSE42>,
+		&traceur::BasicKernel::lightLevelVariant<Graph, traceur::ISA::AVX2>,
+		&traceur::BasicKernel::lightLevelVariant<Graph, traceur::ISA::AVX512>);
+#else
+	state.trace = &traceur::BasicKernel::traceVariant<Graph, traceur::ISA::Baseline>;
+	state.lightLevel = &traceur::BasicKernel::lightLevelVariant<Graph, traceur::ISA::Baseline>;
+#endif
+}
+
+traceur::KernelStatistics traceur::BasicKernel::statistics() const
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	return m_statistics;
+}
@@ -0,0 +1,69 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <traceur/core/kernel/channel.hpp>
+#include <sstream>
+
+const char * traceur::channel_name(traceur::Channels::Channel channel)
+{
+	switch (channel) {
+		case traceur::Channels::Depth:
+			return "depth";
+		case traceur::Channels::Normal:
+			return "normal";
+		case traceur::Channels::Albedo:
+			return "albedo";
+		case traceur::Channels::PrimitiveId:
+			return "primitive";
+		case traceur::Channels::MaterialId:
+			return "material";
+		case traceur::Channels::SampleCount:
+			return "samples";
+		default:
+			return "unknown";
+	}
+}
+
+bool traceur::parse_channels(const std::string &names, unsigned &channels)
+{
+	std::istringstream stream(names);
+	std::string name;
+	unsigned mask = 0;
+
+	while (std::getline(stream, name, ',')) {
+		bool known = false;
+		for (unsigned channel = 1; channel & traceur::Channels::All; channel <<= 1) {
+			if (name == traceur::channel_name(static_cast<traceur::Channels::Channel>(channel))) {
+				mask |= channel;
+				known = true;
+				break;
+			}
+		}
+		if (!known) {
+			return false;
+		}
+	}
+
+	channels = mask;
+	return true;
+}
@@ -0,0 +1,135 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/kernel/curve.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+namespace {
+	/**
+	 * Gather the even bits of the given Morton code into the lower half of
+	 * the result.
+	 *
+	 * @param[in] code The Morton code.
+	 * @return The coordinate encoded by the even bits of the code.
+	 */
+	inline uint32_t compact(uint32_t code)
+	{
+		code &= 0x55555555u;
+		code = (code | (code >> 1)) & 0x33333333u;
+		code = (code | (code >> 2)) & 0x0f0f0f0fu;
+		code = (code | (code >> 4)) & 0x00ff00ffu;
+		code = (code | (code >> 8)) & 0x0000ffffu;
+		return code;
+	}
+
+	/**
+	 * Compute the cell at the given distance along the Hilbert curve that
+	 * fills a grid of the given side.
+	 *
+	 * @param[in] side The side of the grid, which must be a power of two.
+	 * @param[in] d The distance along the curve.
+	 * @return The coordinates of the cell.
+	 */
+	inline glm::ivec2 hilbert(int side, uint32_t d)
+	{
+		glm::ivec2 p(0, 0);
+		for (int s = 1; s < side; s *= 2, d /= 4) {
+			int rx = 1 & static_cast<int>(d / 2);
+			int ry = 1 & static_cast<int>(d ^ static_cast<uint32_t>(rx));
+
+			// rotate the quadrant so the sub-curves connect
+			if (ry == 0) {
+				if (rx == 1) {
+					p = glm::ivec2(s - 1) - p;
+				}
+				std::swap(p.x, p.y);
+			}
+			p += glm::ivec2(s * rx, s * ry);
+		}
+		return p;
+	}
+}
+
+std::vector<glm::ivec2> traceur::curve_points(traceur::SpaceFillingCurve curve, int width, int height)
+{
+	std::vector<glm::ivec2> points;
+	if (width <= 0 || height <= 0) {
+		return points;
+	}
+	points.reserve(static_cast<size_t>(width) * static_cast<size_t>(height));
+
+	if (curve == traceur::SpaceFillingCurve::Scanline) {
+		for (int y = 0; y < height; y++) {
+			for (int x = 0; x < width; x++) {
+				points.emplace_back(x, y);
+			}
+		}
+		return points;
+	}
+
+	// walk the curve over the smallest square grid with a power of two side
+	// that covers the grid
+	int side = 1;
+	while (side < std::max(width, height)) {
+		side *= 2;
+	}
+	uint32_t cells = static_cast<uint32_t>(side) * static_cast<uint32_t>(side);
+
+	for (uint32_t d = 0; d < cells; d++) {
+		glm::ivec2 p = curve == traceur::SpaceFillingCurve::Hilbert
+			? hilbert(side, d)
+			: glm::ivec2(compact(d), compact(d >> 1));
+		if (p.x < width && p.y < height) {
+			points.push_back(p);
+		}
+	}
+	return points;
+}
+
+const char * traceur::curve_name(traceur::SpaceFillingCurve curve)
+{
+	switch (curve) {
+		case traceur::SpaceFillingCurve::Hilbert:
+			return "hilbert";
+		case traceur::SpaceFillingCurve::Morton:
+			return "morton";
+		default:
+			return "scanline";
+	}
+}
+
+bool traceur::parse_curve(const std::string &name, traceur::SpaceFillingCurve &curve)
+{
+	for (auto candidate : { traceur::SpaceFillingCurve::Scanline,
+							traceur::SpaceFillingCurve::Morton,
+							traceur::SpaceFillingCurve::Hilbert }) {
+		if (name == traceur::curve_name(candidate)) {
+			curve = candidate;
+			return true;
+		}
+	}
+	return false;
+}
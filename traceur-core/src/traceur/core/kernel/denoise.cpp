@@ -0,0 +1,169 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <traceur/core/kernel/denoise.hpp>
+#include <algorithm>
+#include <cmath>
+#include <future>
+
+namespace {
+	/**
+	 * The taps of the B3-spline kernel of the à-trous filter from the
+	 * center outwards.
+	 */
+	const float kernel[3] = { 3.f / 8.f, 1.f / 4.f, 1.f / 16.f };
+}
+
+traceur::Denoiser::Denoiser(int workers) :
+	iterations(5), colorPhi(1.f), normalPhi(128.f), depthPhi(0.01f), albedoPhi(0.1f), tileSize(64),
+	pool(std::max(1, workers)) {}
+
+std::unique_ptr<traceur::DirectFilm> traceur::Denoiser::denoise(const traceur::Film &film) const
+{
+	int width = film.width;
+	int height = film.height;
+	size_t size = static_cast<size_t>(width) * static_cast<size_t>(height);
+	bool guided = (film.channels() & traceur::Channels::Auxiliary) == traceur::Channels::Auxiliary;
+
+	std::vector<traceur::Pixel> colors(size);
+	std::vector<traceur::Pixel> filtered(size);
+	std::vector<traceur::AuxiliaryPixel> attributes(guided ? size : 0);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			colors[static_cast<size_t>(y) * width + x] = film(glm::ivec2(x, y));
+		}
+	}
+
+	if (guided) {
+		// the planes of the guiding channels are read from the film once
+		std::vector<traceur::ChannelTraits<traceur::Channels::Albedo>::type> albedoStorage;
+		std::vector<traceur::ChannelTraits<traceur::Channels::Normal>::type> normalStorage;
+		std::vector<traceur::ChannelTraits<traceur::Channels::Depth>::type> depthStorage;
+		auto albedos = film.plane<traceur::Channels::Albedo>(albedoStorage);
+		auto normals = film.plane<traceur::Channels::Normal>(normalStorage);
+		auto depths = film.plane<traceur::Channels::Depth>(depthStorage);
+
+		for (size_t i = 0; i < size; i++) {
+			// the normals are averaged over the primary rays of a pixel
+			auto &attribute = attributes[i];
+			attribute.albedo = albedos[i];
+			attribute.normal = normals[i];
+			attribute.depth = depths[i];
+			float length = glm::length(attribute.normal);
+			if (length > 0) {
+				attribute.normal /= length;
+			}
+		}
+	}
+
+	// filter a tile of the image with taps that lie step pixels apart
+	auto filter = [&](int left, int top, int step, float phi) {
+		int right = std::min(left + tileSize, width);
+		int bottom = std::min(top + tileSize, height);
+
+		for (int y = top; y < bottom; y++) {
+			for (int x = left; x < right; x++) {
+				size_t i = static_cast<size_t>(y) * width + x;
+				auto color = colors[i];
+
+				// pixels that see no surface are kept as is
+				if (guided && attributes[i].depth <= 0) {
+					filtered[i] = color;
+					continue;
+				}
+
+				traceur::Pixel sum(0, 0, 0);
+				float weights = 0;
+				for (int dy = -2; dy <= 2; dy++) {
+					int v = y + dy * step;
+					if (v < 0 || v >= height) {
+						continue;
+					}
+
+					for (int dx = -2; dx <= 2; dx++) {
+						int u = x + dx * step;
+						if (u < 0 || u >= width) {
+							continue;
+						}
+
+						size_t j = static_cast<size_t>(v) * width + u;
+						auto difference = colors[j] - color;
+						float weight = kernel[std::abs(dx)] * kernel[std::abs(dy)]
+							* std::exp(-glm::dot(difference, difference) / phi);
+
+						if (guided) {
+							auto &p = attributes[i];
+							auto &q = attributes[j];
+							if (q.depth <= 0) {
+								continue;
+							}
+
+							auto albedo = q.albedo - p.albedo;
+							weight *= std::pow(std::max(0.f, glm::dot(p.normal, q.normal)), normalPhi)
+								* std::exp(-std::abs(q.depth - p.depth) / (depthPhi * p.depth * step))
+								* std::exp(-glm::dot(albedo, albedo) / albedoPhi);
+						}
+
+						sum += colors[j] * weight;
+						weights += weight;
+					}
+				}
+
+				filtered[i] = weights > 0 ? sum / weights : color;
+			}
+		}
+	};
+
+	for (int iteration = 0; iteration < iterations; iteration++) {
+		int step = 1 << iteration;
+		float phi = std::ldexp(colorPhi, -iteration);
+
+		std::vector<std::future<void>> tiles;
+		for (int top = 0; top < height; top += tileSize) {
+			for (int left = 0; left < width; left += tileSize) {
+				tiles.push_back(pool.enqueue(filter, left, top, step, phi));
+			}
+		}
+		for (auto &tile : tiles) {
+			tile.get();
+		}
+		std::swap(colors, filtered);
+	}
+
+	auto result = std::make_unique<traceur::DirectFilm>(width, height);
+	for (int y = 0; y < height; y++) {
+		for (int x = 0; x < width; x++) {
+			(*result)(glm::ivec2(x, y)) = colors[static_cast<size_t>(y) * width + x];
+		}
+	}
+	return result;
+}
+
+void traceur::DenoisingObserver::renderFinished(const traceur::Kernel &kernel,
+												const traceur::Film &film)
+{
+	m_result = denoiser->denoise(film);
+	for (auto &observer : observers) {
+		observer->renderFinished(kernel, *m_result);
+	}
+}
@@ -23,6 +23,7 @@
  */
 
 #include <traceur/core/kernel/multithreaded.hpp>
+#include <algorithm>
 
 traceur::MultithreadedKernel::MultithreadedKernel(const std::shared_ptr<traceur::Kernel> kernel,
 												  int workers,
@@ -30,6 +31,7 @@ traceur::MultithreadedKernel::MultithreadedKernel(const std::shared_ptr<traceur:
 	: workers(workers),
 	  partitions(partitions),
 	  range(std::pair<int, int>(0, partitions)),
+	  partitionOrder(traceur::SpaceFillingCurve::Scanline),
 	  kernel(kernel),
 	  pool(workers) {}
 
@@ -40,11 +42,19 @@ traceur::MultithreadedKernel::MultithreadedKernel(const std::shared_ptr<traceur:
 	: workers(workers),
 	  partitions(partitions),
 	  range(range),
+	  partitionOrder(traceur::SpaceFillingCurve::Scanline),
 	  kernel(kernel),
 	  pool(workers) {}
 
 std::unique_ptr<traceur::Film> traceur::MultithreadedKernel::render(const traceur::Scene &scene,
 																	const traceur::Camera &camera) const
+{
+	return render(scene, camera, traceur::singlePass);
+}
+
+std::unique_ptr<traceur::Film> traceur::MultithreadedKernel::render(const traceur::Scene &scene,
+																	const traceur::Camera &camera,
+																	int pass) const
 {
 	/* Notify observers about start */
 	for (auto &observer : observers) {
@@ -58,24 +68,77 @@ std::unique_ptr<traceur::Film> traceur::MultithreadedKernel::render(const traceu
 		partitions
 	);
 
+	renderPartitions(scene, camera, *film, glm::ivec2(0, 0), pass, range);
+
+	/* Notify observers about finish */
+	for (auto &observer : observers) {
+		observer->renderFinished(*this, *film);
+	}
+
+	return std::move(film);
+}
+
+void traceur::MultithreadedKernel::render(const traceur::Scene &scene,
+										  const traceur::Camera &camera,
+										  traceur::Film &film,
+										  const glm::ivec2 &offset) const
+{
+	render(scene, camera, film, offset, traceur::singlePass);
+}
+
+void traceur::MultithreadedKernel::render(const traceur::Scene &scene,
+										  const traceur::Camera &camera,
+										  traceur::Film &film,
+										  const glm::ivec2 &offset,
+										  int pass) const
+{
+	/* Divide the part of the screen into partitions of at least a pixel */
+	int count = std::max(1, std::min(partitions, std::min(film.width, film.height)));
+	traceur::PartitionedFilm<traceur::DirectFilm> parts(film.width, film.height, count);
+	renderPartitions(scene, camera, parts, offset, pass, std::pair<int, int>(0, count));
+
+	/* Copy the partitions into the film, of which only direct films hold channels */
+	if (auto direct = dynamic_cast<traceur::DirectFilm *>(&film)) {
+		direct->assign(parts);
+		return;
+	}
+	for (int y = 0; y < film.height; y++) {
+		for (int x = 0; x < film.width; x++) {
+			film(x, y) = parts(glm::ivec2(x, y));
+		}
+	}
+}
+
+void traceur::MultithreadedKernel::renderPartitions(const traceur::Scene &scene,
+													const traceur::Camera &camera,
+													traceur::PartitionedFilm<traceur::DirectFilm> &film,
+													const glm::ivec2 &offset,
+													int pass,
+													std::pair<int, int> range) const
+{
 	auto jobs = std::queue<std::future<void>>();
 
-	/* Enqueue render jobs */
-	for (int i = range.first; i < range.second; i++) {
+	/* Enqueue render jobs along the curve through the partitions */
+	auto grid = film.grid();
+	for (auto &cell : traceur::curve_points(partitionOrder, grid.x, grid.y)) {
+		int i = cell.y * grid.x + cell.x;
+		if (i < range.first || i >= range.second) {
+			continue;
+		}
 		jobs.emplace(pool.enqueue([&, i]() {
-			auto &partition = film->operator()(i);
-			auto offset = film->offset(i);
+			auto &partition = film(i);
+			auto origin = offset + film.offset(i);
 
 			/* Notify observers about start */
 			for (auto &observer : observers) {
-				observer->partitionStarted(*this, i, partition, offset);
+				observer->partitionStarted(*this, i, partition, origin);
 			}
 			/* Render the partition */
-			kernel->render(scene, camera, partition, offset);
+			kernel->render(scene, camera, partition, origin, pass);
 
 			/* Notify observers about finish */
 			for (auto &observer : observers) {
-				observer->partitionFinished(*this, i, partition, offset);
+				observer->partitionFinished(*this, i, partition, origin);
 			}
 		}));
 	}
@@ -86,22 +149,6 @@ std::unique_ptr<traceur::Film> traceur::MultithreadedKernel::render(const traceu
 		jobs.pop();
 		job.wait();
 	}
-
-	/* Notify observers about finish */
-	for (auto &observer : observers) {
-		observer->renderFinished(*this, *film);
-	}
-
-	return std::move(film);
-}
-
-void traceur::MultithreadedKernel::render(const traceur::Scene &scene,
-										  const traceur::Camera &camera,
-										  traceur::Film &film,
-										  const glm::ivec2 &offset) const
-{
-	// XXX This method does not make use of the thread pool
-	kernel->render(scene, camera, film, offset);
 }
 
 traceur::MultithreadedKernelPool::MultithreadedKernelPool(int workers)
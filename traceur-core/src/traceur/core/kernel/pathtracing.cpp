@@ -0,0 +1,405 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <traceur/core/kernel/pathtracing.hpp>
+#include <traceur/core/scene/graph/dispatch.hpp>
+#include <traceur/core/scene/primitive/triangle.hpp>
+#include <traceur/core/sampler/sobol.hpp>
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	/**
+	 * The distance by which the rays leaving a surface are offset from the
+	 * surface along its normal.
+	 */
+	const float rayOffset = 0.0001f;
+
+	/**
+	 * The amount of sample dimensions that a vertex of a path consumes.
+	 */
+	const uint32_t vertexDimensions = 10;
+
+	/**
+	 * The scattering lobes of a material that are not singular.
+	 */
+	struct Lobes {
+		/**
+		 * The reflectance of the Lambertian lobe.
+		 */
+		glm::vec3 diffuse;
+
+		/**
+		 * The reflectance of the Blinn-Phong lobe.
+		 */
+		glm::vec3 glossy;
+
+		/**
+		 * The exponent of the Blinn-Phong lobe.
+		 */
+		float exponent;
+
+		/**
+		 * The probabilities with which the Lambertian and the Blinn-Phong
+		 * lobe are selected to sample a direction.
+		 */
+		float diffuseProbability, glossyProbability;
+	};
+
+	/**
+	 * Evaluate the scattering function of the lobes.
+	 *
+	 * @param[in] lobes The lobes to evaluate.
+	 * @param[in] normal The normal of the surface on the side of the
+	 * outgoing direction.
+	 * @param[in] wo The direction towards which light is scattered.
+	 * @param[in] wi The direction from which light arrives.
+	 * @return The value of the scattering function.
+	 */
+	inline glm::vec3 evaluate(const Lobes &lobes, const glm::vec3 &normal, const glm::vec3 &wo, const glm::vec3 &wi)
+	{
+		const float pi = glm::pi<float>();
+		glm::vec3 result = lobes.diffuse / pi;
+		if (lobes.glossyProbability > 0) {
+			glm::vec3 half = glm::normalize(wo + wi);
+			float cosine = std::max(0.f, glm::dot(normal, half));
+			result += lobes.glossy * ((lobes.exponent + 8.f) / (8.f * pi) * std::pow(cosine, lobes.exponent));
+		}
+		return result;
+	}
+
+	/**
+	 * Return the probability density with which the lobes sample a
+	 * direction, per unit solid angle.
+	 *
+	 * @param[in] lobes The lobes that sample the direction.
+	 * @param[in] normal The normal of the surface on the side of the
+	 * outgoing direction.
+	 * @param[in] wo The direction towards which light is scattered.
+	 * @param[in] wi The direction that is sampled.
+	 * @return The probability density of the direction.
+	 */
+	inline float density(const Lobes &lobes, const glm::vec3 &normal, const glm::vec3 &wo, const glm::vec3 &wi)
+	{
+		const float pi = glm::pi<float>();
+		float cosine = glm::dot(normal, wi);
+		if (cosine <= 0) {
+			return 0;
+		}
+
+		float pdf = lobes.diffuseProbability * cosine / pi;
+		if (lobes.glossyProbability > 0) {
+			glm::vec3 half = glm::normalize(wo + wi);
+			float cosHalf = std::max(0.f, glm::dot(normal, half));
+			float woHalf = glm::dot(wo, half);
+			if (woHalf > 0) {
+				pdf += lobes.glossyProbability * (lobes.exponent + 1.f) / (2.f * pi)
+					* std::pow(cosHalf, lobes.exponent) / (4.f * woHalf);
+			}
+		}
+		return pdf;
+	}
+
+	/**
+	 * Transform a direction from the frame of a normal to world space, using
+	 * the branchless orthonormal basis of Duff et al.
+	 *
+	 * @param[in] normal The normal of the frame.
+	 * @param[in] local The direction in the frame, with the normal along z.
+	 * @return The direction in world space.
+	 */
+	inline glm::vec3 to_world(const glm::vec3 &normal, const glm::vec3 &local)
+	{
+		float sign = std::copysign(1.f, normal.z);
+		float a = -1.f / (sign + normal.z);
+		float b = normal.x * normal.y * a;
+		glm::vec3 tangent(1.f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+		glm::vec3 bitangent(b, sign + normal.y * normal.y * a, -normal.y);
+		return local.x * tangent + local.y * bitangent + local.z * normal;
+	}
+
+	/**
+	 * Combine the densities of two sampling strategies by the power
+	 * heuristic.
+	 *
+	 * @param[in] a The density of the strategy that sampled the direction.
+	 * @param[in] b The density of the other strategy.
+	 * @return The weight of the sample of the first strategy.
+	 */
+	inline float power_heuristic(float a, float b)
+	{
+		a *= a;
+		b *= b;
+		return a + b > 0 ? a / (a + b) : 0.f;
+	}
+}
+
+traceur::PathTracingKernel::PathTracingKernel() :
+	PathTracingKernel(std::make_shared<traceur::SobolSampler>(), 8) {}
+
+traceur::PathTracingKernel::PathTracingKernel(std::shared_ptr<traceur::Sampler> sampler, int maxDepth) :
+	BasicKernel(sampler, 1), maxDepth(maxDepth), rouletteDepth(3), m_generation(0) {}
+
+void traceur::PathTracingKernel::prepare(const traceur::Scene &scene, traceur::RenderState &state) const
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		auto emissions = traceur::material_emissions(scene);
+		if (m_generation != scene.generation || m_emissions != emissions) {
+			m_generation = scene.generation;
+			m_emissions = std::move(emissions);
+			m_emitters = traceur::AreaLights(scene);
+		}
+	}
+
+	// Trace the rays of the job with the path tracer for the type of the
+	// graph and the active instruction set, like the basic kernel does for
+	// its own tracer
+	using Trace = decltype(traceur::RenderState::trace);
+	traceur::visit_graph(*scene.graph, [&](const auto &graph) {
+		using Graph = typename std::decay<decltype(graph)>::type;
+#ifdef TRACEUR_ISA_DISPATCH
+		state.trace = traceur::dispatch<Trace>(
+			static_cast<Trace>(&traceur::PathTracingKernel::radianceVariant<Graph, traceur::ISA::Baseline>),
+			static_cast<Trace>(&traceur::PathTracingKernel::radianceVariant<Graph, traceur::ISA::SSE42>),
+			static_cast<Trace>(&traceur::PathTracingKernel::radianceVariant<Graph, traceur::ISA::AVX2>),
+			static_cast<Trace>(&traceur::PathTracingKernel::radianceVariant<Graph, traceur::ISA::AVX512>));
+#else
+		state.trace = static_cast<Trace>(&traceur::PathTracingKernel::radianceVariant<Graph, traceur::ISA::Baseline>);
+#endif
+	});
+}
+
+template<class Graph, traceur::ISA I>
+traceur::Pixel traceur::PathTracingKernel::radianceVariant(const traceur::Scene &scene,
+														   const traceur::Camera &camera,
+														   const traceur::Ray &ray,
+														   int depth,
+														   traceur::RenderState &state) const
+{
+	return traceur::Target<I>::invoke([&]() {
+		return radiance<Graph>(scene, camera, ray, depth, state);
+	});
+}
+
+template<class Graph>
+traceur::Pixel traceur::PathTracingKernel::radiance(const traceur::Scene &scene,
+													const traceur::Camera &,
+													const traceur::Ray &primary,
+													int,
+													traceur::RenderState &state) const
+{
+	const float pi = glm::pi<float>();
+	auto &graph = static_cast<const Graph &>(*scene.graph);
+	auto &samples = state.samples;
+	uint32_t index = samples.index();
+
+	traceur::Pixel result(0, 0, 0);
+	glm::vec3 throughput(1, 1, 1);
+	traceur::Ray ray = primary;
+
+	// The density with which the direction of the ray was sampled, which is
+	// singular for the primary ray and for mirrors and transmission
+	bool singular = true;
+	float directionPdf = 0;
+
+	for (int bounce = 0; ; bounce++) {
+		traceur::Hit hit;
+		if (!graph.intersect(ray, hit)) {
+			break;
+		}
+
+		auto &material = scene.materials[hit.primitive->material];
+		if (bounce == 0) {
+			state.record(material.diffuse, ray, hit);
+		}
+
+		// Emission, which is weighted against the connection to the same
+		// point if the emitter could have been sampled by the connection
+		if (traceur::luminance(material.emission) > 0) {
+			float weight = 1.f;
+			if (!singular && dynamic_cast<const traceur::Triangle *>(hit.primitive)) {
+				float cosine = std::abs(glm::dot(hit.normal, ray.direction));
+				float lightPdf = cosine > 0
+					? m_emitters.density(material.emission) * hit.distance * hit.distance / cosine : 0.f;
+				weight = power_heuristic(directionPdf, lightPdf);
+			}
+			result += throughput * material.emission * weight;
+		}
+
+		int model = material.illuminationModel;
+		if (model <= 0 || model >= traceur::IlluminationModels) {
+			// Unlit materials show their color as is
+			result += throughput * material.diffuse;
+			break;
+		}
+
+		if (bounce >= maxDepth) {
+			break;
+		}
+
+		// The normal on the side of the surface the ray arrived from
+		glm::vec3 wo = -ray.direction;
+		glm::vec3 normal = glm::dot(hit.normal, wo) >= 0 ? hit.normal : -hit.normal;
+		glm::vec3 position = hit.position + rayOffset * normal;
+
+		// The lobes of the illumination model, weighted as in the shading of
+		// the basic kernel
+		float transparency = model == 4 ? material.transparency : 0.f;
+		glm::vec3 diffuse = (1.f - transparency) * material.diffuse;
+		glm::vec3 specular = model >= 2 ? (1.f - transparency) * material.specular : glm::vec3(0);
+		glm::vec3 transmission = model == 6 || model == 7
+			? (1.f - material.specular) * material.transmissionFilter : glm::vec3(0);
+		bool mirror = model >= 3;
+
+		float diffuseWeight = traceur::luminance(diffuse);
+		float specularWeight = traceur::luminance(specular);
+		float refractionWeight = traceur::luminance(transmission);
+		float total = diffuseWeight + specularWeight + transparency + refractionWeight;
+		if (total <= 0) {
+			break;
+		}
+
+		Lobes lobes;
+		lobes.diffuse = diffuse;
+		lobes.glossy = mirror ? glm::vec3(0) : specular;
+		lobes.exponent = material.shininess;
+		lobes.diffuseProbability = diffuseWeight / total;
+		lobes.glossyProbability = mirror ? 0.f : specularWeight / total;
+
+		uint32_t dimension = samples.reserve(vertexDimensions);
+
+		// Next-event estimation towards the emissive triangles and the point
+		// lights, if the surface has a lobe that can be connected to them
+		if (lobes.diffuseProbability + lobes.glossyProbability > 0) {
+			if (!m_emitters.empty()) {
+				glm::vec3 point;
+				glm::vec2 uv(samples(index, dimension + 1), samples(index, dimension + 2));
+				auto &light = m_emitters.sample(samples(index, dimension), uv, point);
+
+				glm::vec3 towards = point - position;
+				float distance2 = glm::dot(towards, towards);
+				float distance = std::sqrt(distance2);
+				glm::vec3 wi = towards / distance;
+				float cosine = glm::dot(normal, wi);
+				float lightCosine = std::abs(glm::dot(light.normal, wi));
+
+				if (cosine > 0 && lightCosine > 0) {
+					state.statistics.shadowRays++;
+					if (!graph.occluded(traceur::Ray(position, wi), distance - occluderEpsilon)) {
+						float lightPdf = m_emitters.density(light.emission) * distance2 / lightCosine;
+						float weight = power_heuristic(lightPdf, density(lobes, normal, wo, wi));
+						result += throughput * evaluate(lobes, normal, wo, wi) * light.emission
+							* (cosine * weight / lightPdf);
+					}
+				}
+			}
+
+			glm::vec3 jitter(samples(index, dimension + 3), samples(index, dimension + 4),
+							 samples(index, dimension + 5));
+			for (auto &light : scene.lights) {
+				glm::vec3 towards = light + (2.f * jitter - 1.f) * lightRadius - position;
+				float distance2 = glm::dot(towards, towards);
+				float distance = std::sqrt(distance2);
+				glm::vec3 wi = towards / distance;
+				float cosine = glm::dot(normal, wi);
+
+				if (cosine > 0) {
+					state.statistics.shadowRays++;
+					if (!graph.occluded(traceur::Ray(position, wi), distance)) {
+						result += throughput * evaluate(lobes, normal, wo, wi) * (cosine / distance2);
+					}
+				}
+			}
+		}
+
+		// Sample the direction of the next ray from one of the lobes
+		float u = samples(index, dimension + 6) * total;
+		glm::vec2 r(samples(index, dimension + 7), samples(index, dimension + 8));
+		glm::vec3 direction;
+
+		if (u < diffuseWeight || (!mirror && u < diffuseWeight + specularWeight)) {
+			if (u < diffuseWeight) {
+				// Cosine-weighted hemisphere
+				float radius = std::sqrt(r.x);
+				float phi = 2.f * pi * r.y;
+				glm::vec3 local(radius * std::cos(phi), radius * std::sin(phi), std::sqrt(std::max(0.f, 1.f - r.x)));
+				direction = to_world(normal, local);
+			} else {
+				// Half vector of the Blinn-Phong lobe
+				float cosTheta = std::pow(r.x, 1.f / (lobes.exponent + 1.f));
+				float sinTheta = std::sqrt(std::max(0.f, 1.f - cosTheta * cosTheta));
+				float phi = 2.f * pi * r.y;
+				glm::vec3 half = to_world(normal, glm::vec3(sinTheta * std::cos(phi), sinTheta * std::sin(phi), cosTheta));
+				direction = 2.f * glm::dot(wo, half) * half - wo;
+			}
+
+			float cosine = glm::dot(normal, direction);
+			float pdf = density(lobes, normal, wo, direction);
+			if (cosine <= 0 || pdf <= 0) {
+				break;
+			}
+
+			throughput *= evaluate(lobes, normal, wo, direction) * (cosine / pdf);
+			singular = false;
+			directionPdf = pdf;
+		} else {
+			if (u < diffuseWeight + specularWeight) {
+				// Ideal mirror
+				direction = glm::reflect(ray.direction, normal);
+				throughput *= specular * (total / specularWeight);
+			} else if (u < diffuseWeight + specularWeight + transparency) {
+				// Transparency
+				direction = ray.direction;
+				throughput *= total;
+			} else {
+				// Refraction, which falls back to reflection on total
+				// internal reflection
+				float eta = glm::dot(hit.normal, ray.direction) < 0 ? 1.f / material.opticalDensity : material.opticalDensity;
+				direction = glm::refract(ray.direction, normal, eta);
+				if (glm::dot(direction, direction) == 0 || std::isnan(direction.x)) {
+					direction = glm::reflect(ray.direction, normal);
+				}
+				throughput *= transmission * (total / refractionWeight);
+			}
+			singular = true;
+		}
+
+		// Terminate the path by Russian roulette once it is long enough
+		if (bounce >= rouletteDepth) {
+			float survival = std::min(0.95f, std::max(throughput.x, std::max(throughput.y, throughput.z)));
+			if (samples(index, dimension + 9) >= survival) {
+				break;
+			}
+			throughput /= survival;
+		}
+
+		glm::vec3 side = glm::dot(direction, normal) >= 0 ? normal : -normal;
+		ray = traceur::Ray(hit.position + rayOffset * side, direction);
+	}
+
+	return result;
+}
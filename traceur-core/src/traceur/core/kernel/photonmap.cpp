@@ -0,0 +1,242 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <traceur/core/kernel/photonmap.hpp>
+#include <traceur/core/scene/primitive/primitive.hpp>
+#include <traceur/core/sampler/sobol.hpp>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	/**
+	 * The maximum amount of bounces of a photon, which matches the maximum
+	 * recursion depth of the basic kernel.
+	 */
+	const int maxBounces = 8;
+}
+
+traceur::PhotonMapKernel::PhotonMapKernel() :
+	PhotonMapKernel(std::make_shared<traceur::SobolSampler>(), 50, 200000,
+					std::max(1, static_cast<int>(std::thread::hardware_concurrency()))) {}
+
+traceur::PhotonMapKernel::PhotonMapKernel(std::shared_ptr<traceur::Sampler> sampler,
+										  int lightSamples,
+										  int photons,
+										  int workers,
+										  unsigned features) :
+	BasicKernel(sampler, lightSamples, features), photons(photons), neighbours(64), radius(0.1f),
+	workers(workers), m_generation(0), m_settings(0, 0, 0.f) {}
+
+void traceur::PhotonMapKernel::prepare(const traceur::Scene &scene, traceur::RenderState &state) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	auto settings = std::make_tuple(photons, neighbours, radius);
+	auto emissions = traceur::material_emissions(scene);
+	if (m_generation != scene.generation || m_lights != scene.lights
+		|| m_emissions != emissions || m_settings != settings) {
+		m_generation = scene.generation;
+		m_lights = scene.lights;
+		m_emissions = std::move(emissions);
+		m_settings = settings;
+
+		/* The engine is kept across rebuilds, unless the amount of
+		 * workers has changed */
+		if (!m_queries || m_queries->workers != std::max(1, workers)) {
+			m_queries.reset(new traceur::RayQueryEngine(std::max(1, workers)));
+		}
+
+		/* Emit the photons of every light, followed by the photons of the
+		 * emissive triangles */
+		m_emitters = traceur::AreaLights(scene);
+		size_t lights = scene.lights.size() + (m_emitters.empty() ? 0 : 1);
+		std::vector<Path> paths;
+		uint32_t count = static_cast<uint32_t>(std::max(0, photons));
+		paths.reserve(lights * count);
+		for (size_t light = 0; light < lights; light++) {
+			for (uint32_t index = 0; index < count; index++) {
+				paths.push_back(emit(scene, light, index));
+			}
+		}
+
+		/* Trace the photons that are still travelling one bounce at a time,
+		 * so that every bounce is a single batch of rays */
+		std::vector<traceur::Photon> stored;
+		std::vector<traceur::Ray> rays;
+		std::vector<traceur::Hit> hits;
+		for (int bounce = 0; bounce < maxBounces && !paths.empty(); bounce++) {
+			rays.resize(paths.size());
+			hits.resize(paths.size());
+			for (size_t i = 0; i < paths.size(); i++) {
+				rays[i] = paths[i].ray;
+			}
+			m_queries->intersect(*scene.graph, rays.data(), hits.data(), rays.size());
+
+			size_t travelling = 0;
+			for (size_t i = 0; i < paths.size(); i++) {
+				if (scatter(scene, paths[i], hits[i], bounce, stored)) {
+					paths[travelling++] = paths[i];
+				}
+			}
+			paths.resize(travelling);
+		}
+
+		m_caustics = traceur::PhotonMap(std::move(stored), neighbours, radius);
+	}
+
+	state.caustics = m_caustics.empty() ? nullptr : &m_caustics;
+}
+
+traceur::PhotonMapKernel::Path traceur::PhotonMapKernel::emit(const traceur::Scene &scene,
+																size_t light,
+																uint32_t index) const
+{
+	/* The photons of a light draw their samples from a row of pixels of
+	 * their own, outside of the film */
+	glm::ivec2 pixel(static_cast<int>(light), -1);
+	const float pi = glm::pi<float>();
+
+	if (light >= scene.lights.size()) {
+		/* Emit the photon from a point of an emissive triangle, which is
+		 * chosen in proportion to its power */
+		glm::vec3 origin;
+		auto &emitter = m_emitters.sample(sampler->sample(pixel, index, 0),
+										  glm::vec2(sampler->sample(pixel, index, 1),
+													sampler->sample(pixel, index, 2)),
+										  origin);
+
+		/* The triangle emits from both of its sides, so the side is chosen
+		 * by the first half of the sample and the direction is distributed
+		 * by the cosine about the normal of that side */
+		float u = 2.f * sampler->sample(pixel, index, 3);
+		glm::vec3 normal = u < 1.f ? emitter.normal : -emitter.normal;
+		u = u < 1.f ? u : u - 1.f;
+		float phi = 2.f * pi * sampler->sample(pixel, index, 4);
+		float r = std::sqrt(u);
+		glm::vec3 tangent = glm::normalize(emitter.u);
+		glm::vec3 bitangent = glm::cross(normal, tangent);
+		glm::vec3 direction = r * std::cos(phi) * tangent + r * std::sin(phi) * bitangent
+			+ std::sqrt(std::max(0.f, 1.f - u)) * normal;
+
+		/* The radiance times the cosine over the density of the point, the
+		 * side and the direction */
+		float density = m_emitters.density(emitter.emission) * static_cast<float>(std::max(1, photons));
+		glm::vec3 power = emitter.emission * (2.f * pi / density);
+		return { traceur::Ray(origin + globalOffset * normal, direction), power, pixel, index, false };
+	}
+
+	/* Every light emits a unit intensity uniformly over the sphere */
+	glm::vec3 power = glm::vec3(4.f * pi / static_cast<float>(std::max(1, photons)));
+
+	/* Emit the photon from the cube in which the light is sampled */
+	glm::vec3 jitter(sampler->sample(pixel, index, 0),
+					 sampler->sample(pixel, index, 1),
+					 sampler->sample(pixel, index, 2));
+	glm::vec3 origin = scene.lights[light] + (2.f * jitter - 1.f) * lightRadius;
+
+	float z = 1.f - 2.f * sampler->sample(pixel, index, 3);
+	float phi = 2.f * pi * sampler->sample(pixel, index, 4);
+	float r = std::sqrt(std::max(0.f, 1.f - z * z));
+	glm::vec3 direction(r * std::cos(phi), r * std::sin(phi), z);
+
+	return { traceur::Ray(origin, direction), power, pixel, index, false };
+}
+
+bool traceur::PhotonMapKernel::scatter(const traceur::Scene &scene,
+									   traceur::PhotonMapKernel::Path &path,
+									   const traceur::Hit &hit,
+									   int bounce,
+									   std::vector<traceur::Photon> &stored) const
+{
+	if (!hit.primitive) {
+		return false;
+	}
+
+	auto &ray = path.ray;
+	auto &material = scene.materials[hit.primitive->material];
+	int model = material.illuminationModel;
+	if (model <= 0 || model >= traceur::IlluminationModels) {
+		/* Unlit surfaces absorb the photon */
+		return false;
+	}
+
+	/* Only the photons that arrive after a specular bounce are caustics, the
+	 * others are direct illumination */
+	if (path.specular && traceur::luminance(material.diffuse) > 0) {
+		stored.push_back({ hit.position, path.flux, ray.direction, 0 });
+	}
+
+	/* Choose the specular event by Russian roulette, weighted as in the
+	 * shading of the basic kernel */
+	float transparency = model == 4 ? material.transparency : 0.f;
+	glm::vec3 reflectance = model >= 3
+		? (1.f - transparency) * material.specular : glm::vec3(0);
+	glm::vec3 transmittance = model == 6 || model == 7
+		? (1.f - material.specular) * material.transmissionFilter : glm::vec3(0);
+
+	float reflects = traceur::luminance(reflectance);
+	float refracts = traceur::luminance(transmittance);
+	float total = reflects + transparency + refracts;
+	if (total <= 0) {
+		return false;
+	}
+
+	/* Normalise the probabilities if the events would create energy */
+	float scale = std::max(1.f, total);
+	float u = sampler->sample(path.pixel, path.index, static_cast<uint32_t>(5 + bounce)) * scale;
+
+	glm::vec3 normal = hit.normal;
+	glm::vec3 direction;
+	if (u < reflects) {
+		path.flux *= reflectance * (scale / reflects);
+		direction = glm::reflect(ray.direction, normal);
+	} else if (u < reflects + transparency) {
+		path.flux *= scale;
+		direction = ray.direction;
+	} else if (u < total) {
+		path.flux *= transmittance * (scale / refracts);
+
+		float eta;
+		if (glm::dot(normal, ray.direction) < 0) {
+			eta = 1.f / material.opticalDensity;
+		} else {
+			eta = material.opticalDensity;
+			normal = -normal;
+		}
+
+		direction = glm::refract(ray.direction, normal, eta);
+		if (std::isnan(direction.x) || std::isnan(direction.y) || std::isnan(direction.z)
+			|| glm::dot(direction, direction) == 0) {
+			/* Total internal reflection */
+			direction = glm::reflect(ray.direction, normal);
+		}
+	} else {
+		return false;
+	}
+
+	path.specular = true;
+	ray = traceur::Ray(hit.position + globalOffset * direction, direction);
+	return true;
+}
@@ -0,0 +1,118 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <chrono>
+
+#include <traceur/core/kernel/progressive.hpp>
+
+traceur::ProgressiveKernel::ProgressiveKernel(const std::shared_ptr<traceur::Kernel> kernel,
+											  int passes,
+											  double budget)
+	: passes(passes),
+	  budget(budget),
+	  kernel(kernel) {}
+
+bool traceur::ProgressiveKernel::proceed(int pass, double elapsed, double budget) const
+{
+	if (pass == 0) {
+		return true;
+	} else if (passes > 0 && pass >= passes) {
+		return false;
+	} else if (budget > 0) {
+		// Only start a pass that is expected to finish within the budget
+		return elapsed + elapsed / pass <= budget;
+	}
+	return passes > 0;
+}
+
+std::unique_ptr<traceur::Film> traceur::ProgressiveKernel::render(const traceur::Scene &scene,
+																  const traceur::Camera &camera) const
+{
+	/* Notify observers about start */
+	for (auto &observer : observers) {
+		observer->renderStarted(*this, scene, camera, 1);
+	}
+
+	auto film = std::make_unique<traceur::AccumulationFilm>(camera.viewport[2], camera.viewport[3]);
+	auto begin = std::chrono::high_resolution_clock::now();
+	double elapsed = 0;
+
+	for (int pass = 0; proceed(pass, elapsed, budget); pass++) {
+		film->accumulate(*kernel->render(scene, camera, pass));
+
+		/* Notify observers about the pass */
+		for (auto &observer : observers) {
+			observer->passFinished(*this, pass, *film);
+		}
+
+		auto end = std::chrono::high_resolution_clock::now();
+		elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin).count();
+	}
+
+	/* Notify observers about finish */
+	for (auto &observer : observers) {
+		observer->renderFinished(*this, *film);
+	}
+
+	return std::move(film);
+}
+
+void traceur::ProgressiveKernel::render(const traceur::Scene &scene,
+										const traceur::Camera &camera,
+										traceur::Film &film,
+										const glm::ivec2 &offset) const
+{
+	auto result = traceur::AccumulationFilm(film.width, film.height);
+	auto pass = traceur::DirectFilm(film.width, film.height);
+	auto begin = std::chrono::high_resolution_clock::now();
+	double elapsed = 0;
+
+	// the budget of the render job is split across the parts of the screen
+	// by their area, so the job also finishes within its budget when the
+	// parts are rendered one after another
+	double area = static_cast<double>(film.width) * film.height;
+	double screen = static_cast<double>(camera.viewport[2]) * camera.viewport[3];
+	double share = screen > 0 ? budget * std::min(1.0, area / screen) : budget;
+
+	for (int i = 0; proceed(i, elapsed, share); i++) {
+		kernel->render(scene, camera, pass, offset, i);
+		result.accumulate(pass);
+
+		auto end = std::chrono::high_resolution_clock::now();
+		elapsed = std::chrono::duration_cast<std::chrono::duration<double>>(end - begin).count();
+	}
+
+	// the channels of the passes, such as the albedo and the sample counts,
+	// are only held by direct films
+	if (auto direct = dynamic_cast<traceur::DirectFilm *>(&film)) {
+		direct->assign(result);
+		return;
+	}
+
+	for (int y = 0; y < film.height; y++) {
+		for (int x = 0; x < film.width; x++) {
+			film(x, y) = result(glm::ivec2(x, y));
+		}
+	}
+}
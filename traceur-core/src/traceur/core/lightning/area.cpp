@@ -0,0 +1,125 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <traceur/core/lightning/area.hpp>
+#include <traceur/core/kernel/pixel.hpp>
+#include <traceur/core/scene/primitive/triangle.hpp>
+#include <traceur/core/scene/graph/visitor.hpp>
+#include <traceur/core/scene/scene.hpp>
+#include <algorithm>
+#include <cmath>
+#include <tuple>
+
+namespace {
+	/**
+	 * A visitor that collects the emissive triangles of a scene graph.
+	 */
+	class EmitterVisitor : public traceur::SceneGraphVisitor {
+	public:
+		using traceur::SceneGraphVisitor::visit;
+
+		/**
+		 * The materials of the scene.
+		 */
+		const std::vector<traceur::Material> &materials;
+
+		/**
+		 * The emissive triangles that have been visited.
+		 */
+		std::vector<traceur::AreaLight> lights;
+
+		explicit EmitterVisitor(const std::vector<traceur::Material> &materials) : materials(materials) {}
+
+		virtual void visit(const traceur::Triangle &triangle) final
+		{
+			auto &emission = materials[triangle.material].emission;
+			float area = 0.5f * glm::length(glm::cross(triangle.u, triangle.v));
+			if (traceur::luminance(emission) > 0 && area > 0) {
+				lights.push_back({ triangle.origin, triangle.u, triangle.v, triangle.n, emission, area });
+			}
+		}
+	};
+
+	/**
+	 * Order the lights by their geometry, so that the copies of a triangle
+	 * that is referenced by several leaves of a graph are adjacent.
+	 */
+	inline bool before(const traceur::AreaLight &a, const traceur::AreaLight &b)
+	{
+		return std::tie(a.origin.x, a.origin.y, a.origin.z, a.u.x, a.u.y, a.u.z, a.v.x, a.v.y, a.v.z)
+			< std::tie(b.origin.x, b.origin.y, b.origin.z, b.u.x, b.u.y, b.u.z, b.v.x, b.v.y, b.v.z);
+	}
+
+	/**
+	 * Determine whether two lights are copies of the same triangle.
+	 */
+	inline bool same(const traceur::AreaLight &a, const traceur::AreaLight &b)
+	{
+		return a.origin == b.origin && a.u == b.u && a.v == b.v;
+	}
+}
+
+traceur::AreaLights::AreaLights(const traceur::Scene &scene) : power(0)
+{
+	EmitterVisitor visitor(scene.materials);
+	scene.graph->accept(visitor);
+
+	lights = std::move(visitor.lights);
+	std::sort(lights.begin(), lights.end(), before);
+	lights.erase(std::unique(lights.begin(), lights.end(), same), lights.end());
+
+	cdf.reserve(lights.size());
+	for (auto &light : lights) {
+		power += light.area * traceur::luminance(light.emission);
+		cdf.push_back(power);
+	}
+}
+
+const traceur::AreaLight & traceur::AreaLights::sample(float sample,
+													   const glm::vec2 &point,
+													   glm::vec3 &position) const
+{
+	auto it = std::upper_bound(cdf.begin(), cdf.end(), sample * power);
+	size_t index = std::min(static_cast<size_t>(it - cdf.begin()), lights.size() - 1);
+	auto &light = lights[index];
+
+	/* Map the unit square uniformly onto the triangle */
+	float s = std::sqrt(point.x);
+	position = light.origin + (s * (1.f - point.y)) * light.u + (s * point.y) * light.v;
+	return light;
+}
+
+float traceur::AreaLights::density(const glm::vec3 &emission) const
+{
+	return power > 0 ? traceur::luminance(emission) / power : 0.f;
+}
+
+std::vector<glm::vec3> traceur::material_emissions(const traceur::Scene &scene)
+{
+	std::vector<glm::vec3> emissions;
+	emissions.reserve(scene.materials.size());
+	for (auto &material : scene.materials) {
+		emissions.push_back(material.emission);
+	}
+	return emissions;
+}
@@ -0,0 +1,252 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/lightning/cache.hpp>
+#include <traceur/core/scene/graph/node.hpp>
+#include <traceur/core/scene/scene.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+	/**
+	 * The amount of consecutive entries a key may be stored in.
+	 */
+	constexpr int Probes = 8;
+
+	/**
+	 * The minimum amount of cells a lookup interpolates.
+	 */
+	constexpr int MinimumCells = 2;
+
+	/**
+	 * A visitor that computes the bounds of the nodes of a scene graph.
+	 */
+	class BoundsVisitor : public traceur::SceneGraphVisitor {
+	public:
+		using traceur::SceneGraphVisitor::visit;
+
+		/**
+		 * The bounds of the nodes that have been visited.
+		 */
+		traceur::AABB bounds = traceur::AABB::empty();
+
+		virtual void visit(const traceur::Node &node) final
+		{
+			bounds = bounds.expand(node.bounding_box());
+		}
+	};
+
+	/**
+	 * Scramble the bits of the given value (the finalizer of SplitMix64).
+	 *
+	 * @param[in] value The value to scramble.
+	 * @return The scrambled value.
+	 */
+	inline uint64_t scramble(uint64_t value)
+	{
+		value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+		value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+		return value ^ (value >> 31);
+	}
+
+	/**
+	 * Compute the hash of an entry of the cache.
+	 *
+	 * @param[in] cell The cell of the entry.
+	 * @param[in] face The orientation of the surface of the entry.
+	 * @param[in] light The light of the entry.
+	 * @return The hash of the entry.
+	 */
+	inline uint64_t hash(const glm::ivec3 &cell, int face, size_t light)
+	{
+		uint64_t h = scramble(static_cast<uint32_t>(cell.x) | (static_cast<uint64_t>(static_cast<uint32_t>(cell.y)) << 32));
+		h = scramble(h ^ static_cast<uint32_t>(cell.z) ^ (static_cast<uint64_t>(face) << 32));
+		return scramble(h ^ static_cast<uint64_t>(light));
+	}
+
+	/**
+	 * Compute the tag of a hash, which is never zero.
+	 *
+	 * @param[in] hash The hash of an entry.
+	 * @return The tag of the entry.
+	 */
+	inline uint64_t tag(uint64_t hash)
+	{
+		return (hash >> 16) | (1ull << 47);
+	}
+
+	/**
+	 * Determine the major orientation of a surface, which is the axis of
+	 * the largest component of its normal times two, plus one if that
+	 * component is negative.
+	 *
+	 * @param[in] normal The normal of the surface.
+	 * @return The orientation of the surface in the range [0, 6).
+	 */
+	inline int orientation(const glm::vec3 &normal)
+	{
+		glm::vec3 magnitude = glm::abs(normal);
+		int axis = magnitude.x >= magnitude.y ? (magnitude.x >= magnitude.z ? 0 : 2) : (magnitude.y >= magnitude.z ? 1 : 2);
+		return 2 * axis + (normal[axis] < 0);
+	}
+}
+
+traceur::VisibilityCache::VisibilityCache(int resolution, float tolerance, size_t capacity)
+	: resolution(resolution), tolerance(tolerance), origin(0), cellSize(0), generation(0)
+{
+	size_t size = Probes;
+	while (size < capacity) {
+		size *= 2;
+	}
+	entries.reset(new std::atomic<uint64_t>[size]);
+	mask = size - 1;
+	clear();
+}
+
+void traceur::VisibilityCache::attach(const traceur::Scene &scene)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (generation == scene.generation && lights == scene.lights) {
+		return;
+	}
+
+	clear();
+	generation = scene.generation;
+	lights = scene.lights;
+
+	/* Lay the grid over the bounds of the geometry */
+	BoundsVisitor visitor;
+	scene.graph->accept(visitor);
+	glm::vec3 extent = visitor.bounds.max - visitor.bounds.min;
+	float longest = std::max(std::max(extent.x, extent.y), extent.z);
+	origin = visitor.bounds.min;
+	cellSize = longest > 0 ? longest / std::max(resolution, 1) : 0;
+}
+
+void traceur::VisibilityCache::clear()
+{
+	for (size_t i = 0; i <= mask; i++) {
+		entries[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+bool traceur::VisibilityCache::lookup(const glm::vec3 &position,
+									  const glm::vec3 &normal,
+									  size_t light,
+									  float &visibility) const
+{
+	if (cellSize <= 0) {
+		return false;
+	}
+
+	/* Interpolate between the centers of the cells in the plane of the
+	 * surface, within the layer of cells that contains the point */
+	int face = orientation(normal);
+	int axis = face / 2;
+	int u = (axis + 1) % 3;
+	int v = (axis + 2) % 3;
+	glm::vec3 grid = (position - origin) / cellSize;
+	glm::ivec3 base;
+	base[axis] = static_cast<int>(std::floor(grid[axis]));
+	base[u] = static_cast<int>(std::floor(grid[u] - 0.5f));
+	base[v] = static_cast<int>(std::floor(grid[v] - 0.5f));
+	float fu = grid[u] - 0.5f - base[u];
+	float fv = grid[v] - 0.5f - base[v];
+
+	float weights[4] = { (1 - fu) * (1 - fv), fu * (1 - fv), (1 - fu) * fv, fu * fv };
+	float sum = 0, weight = 0;
+	float lo = 1, hi = 0;
+	int count = 0;
+	for (int i = 0; i < 4; i++) {
+		glm::ivec3 cell = base;
+		cell[u] += i & 1;
+		cell[v] += i >> 1;
+
+		float value;
+		if (!find(hash(cell, face, light), value)) {
+			continue;
+		}
+		sum += weights[i] * value;
+		weight += weights[i];
+		lo = std::min(lo, value);
+		hi = std::max(hi, value);
+		count++;
+	}
+
+	/* Require a second cell to confirm the first, and miss near the edges
+	 * of shadows, where the cells disagree */
+	if (count < MinimumCells || hi - lo > tolerance || weight <= 0) {
+		return false;
+	}
+
+	visibility = sum / weight;
+	return true;
+}
+
+void traceur::VisibilityCache::store(const glm::vec3 &position,
+									 const glm::vec3 &normal,
+									 size_t light,
+									 float visibility)
+{
+	if (cellSize <= 0) {
+		return;
+	}
+
+	auto cell = glm::ivec3(glm::floor((position - origin) / cellSize));
+	uint64_t h = hash(cell, orientation(normal), light);
+	uint64_t t = tag(h);
+	uint64_t entry = (t << 16) | static_cast<uint64_t>(glm::clamp(visibility, 0.f, 1.f) * 65535.f + 0.5f);
+
+	/* Claim an empty entry or replace the entry of the same key */
+	for (int i = 0; i < Probes; i++) {
+		auto &slot = entries[(h + i) & mask];
+		uint64_t current = slot.load(std::memory_order_relaxed);
+		if (current == 0 && slot.compare_exchange_strong(current, entry, std::memory_order_relaxed)) {
+			return;
+		}
+		if ((current >> 16) == t) {
+			slot.store(entry, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	/* Evict the first entry if all entries are taken */
+	entries[h & mask].store(entry, std::memory_order_relaxed);
+}
+
+bool traceur::VisibilityCache::find(uint64_t hash, float &visibility) const
+{
+	uint64_t t = tag(hash);
+	for (int i = 0; i < Probes; i++) {
+		uint64_t entry = entries[(hash + i) & mask].load(std::memory_order_relaxed);
+		if (entry == 0) {
+			return false;
+		}
+		if ((entry >> 16) == t) {
+			visibility = static_cast<float>(entry & 0xffff) / 65535.f;
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,173 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/lightning/photon.hpp>
+#include <algorithm>
+#include <cstdint>
+
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	/**
+	 * A photon that has been gathered by a query of the photon map, which
+	 * is ordered by its distance, so the farthest photon is at the top of a
+	 * heap.
+	 */
+	struct Candidate {
+		float distance2;
+		const traceur::Photon *photon;
+
+		inline bool operator<(const Candidate &other) const
+		{
+			return distance2 < other.distance2;
+		}
+	};
+
+	/**
+	 * A range of photons that remains to be visited by a query, with a lower
+	 * bound of the squared distance of its photons to the queried point.
+	 */
+	struct Range {
+		size_t begin;
+		size_t end;
+		float distance2;
+	};
+}
+
+traceur::PhotonMap::PhotonMap(std::vector<traceur::Photon> photons, int neighbours, float radius)
+	: neighbours(neighbours), radius(radius), photons(std::move(photons))
+{
+	build(0, this->photons.size());
+}
+
+void traceur::PhotonMap::build(size_t begin, size_t end)
+{
+	if (begin >= end) {
+		return;
+	}
+
+	/* Split along the longest axis of the bounds of the range */
+	glm::vec3 min = photons[begin].position;
+	glm::vec3 max = min;
+	for (size_t i = begin + 1; i < end; i++) {
+		min = glm::min(min, photons[i].position);
+		max = glm::max(max, photons[i].position);
+	}
+	glm::vec3 extent = max - min;
+	int axis = extent.x >= extent.y ? (extent.x >= extent.z ? 0 : 2) : (extent.y >= extent.z ? 1 : 2);
+
+	size_t middle = begin + (end - begin) / 2;
+	std::nth_element(photons.begin() + begin, photons.begin() + middle, photons.begin() + end,
+		[axis](const traceur::Photon &a, const traceur::Photon &b) {
+			return a.position[axis] < b.position[axis];
+		});
+	photons[middle].axis = axis;
+
+	build(begin, middle);
+	build(middle + 1, end);
+}
+
+int traceur::PhotonMap::nearest(const glm::vec3 &position,
+								int k,
+								float maxDistance,
+								const traceur::Photon **nearest,
+								float &distance2) const
+{
+	k = std::max(1, std::min(k, MaximumNeighbours));
+	float max2 = maxDistance * maxDistance;
+
+	Candidate heap[MaximumNeighbours];
+	int count = 0;
+
+	/* The tree is balanced, so the stack never exceeds its depth */
+	Range stack[2 * 64];
+	int size = 0;
+	stack[size++] = { 0, photons.size(), 0.f };
+
+	while (size > 0) {
+		Range range = stack[--size];
+		if (range.begin >= range.end || range.distance2 > max2) {
+			continue;
+		}
+
+		size_t middle = range.begin + (range.end - range.begin) / 2;
+		const traceur::Photon &photon = photons[middle];
+
+		glm::vec3 delta = photon.position - position;
+		float d2 = glm::dot(delta, delta);
+		if (d2 < max2) {
+			/* Replace the farthest photon once k photons have been found */
+			if (count == k) {
+				std::pop_heap(heap, heap + count);
+				count--;
+			}
+			heap[count++] = { d2, &photon };
+			std::push_heap(heap, heap + count);
+			if (count == k) {
+				max2 = heap[0].distance2;
+			}
+		}
+
+		/* Visit the side of the plane that contains the point first */
+		float plane = position[photon.axis] - photon.position[photon.axis];
+		Range left = { range.begin, middle, range.distance2 };
+		Range right = { middle + 1, range.end, range.distance2 };
+		if (plane < 0) {
+			right.distance2 = std::max(range.distance2, plane * plane);
+			stack[size++] = right;
+			stack[size++] = left;
+		} else {
+			left.distance2 = std::max(range.distance2, plane * plane);
+			stack[size++] = left;
+			stack[size++] = right;
+		}
+	}
+
+	for (int i = 0; i < count; i++) {
+		nearest[i] = heap[i].photon;
+	}
+	distance2 = count == k ? heap[0].distance2 : maxDistance * maxDistance;
+	return count;
+}
+
+glm::vec3 traceur::PhotonMap::irradiance(const glm::vec3 &position, const glm::vec3 &normal) const
+{
+	if (photons.empty() || neighbours <= 0) {
+		return glm::vec3(0);
+	}
+
+	const traceur::Photon *found[MaximumNeighbours];
+	float distance2;
+	int count = nearest(position, neighbours, radius, found, distance2);
+
+	/* Only photons that arrived at the front of the surface contribute */
+	glm::vec3 power(0);
+	for (int i = 0; i < count; i++) {
+		if (glm::dot(found[i]->direction, normal) < 0) {
+			power += found[i]->power;
+		}
+	}
+
+	return distance2 > 0 ? power / (glm::pi<float>() * distance2) : glm::vec3(0);
+}
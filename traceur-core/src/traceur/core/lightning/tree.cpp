@@ -0,0 +1,153 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+
+#include <traceur/core/lightning/tree.hpp>
+#include <traceur/core/sampler/sampler.hpp>
+
+traceur::LightTree::LightTree(const std::vector<traceur::Light> &lights)
+{
+	if (lights.empty()) {
+		return;
+	}
+
+	std::vector<int> indices(lights.size());
+	for (size_t i = 0; i < lights.size(); i++) {
+		indices[i] = static_cast<int>(i);
+	}
+
+	nodes.reserve(2 * lights.size() - 1);
+	build(lights, indices, 0, static_cast<int>(lights.size()));
+}
+
+int traceur::LightTree::build(const std::vector<traceur::Light> &lights,
+							  std::vector<int> &indices,
+							  int begin,
+							  int end)
+{
+	int index = static_cast<int>(nodes.size());
+	nodes.emplace_back();
+
+	auto min = lights[indices[begin]];
+	auto max = min;
+	for (int i = begin + 1; i < end; i++) {
+		min = glm::min(min, lights[indices[i]]);
+		max = glm::max(max, lights[indices[i]]);
+	}
+
+	int light = -1;
+	int right = -1;
+	if (end - begin == 1) {
+		light = indices[begin];
+	} else {
+		// Split the lights at the median of the longest axis of the bounds
+		auto extent = max - min;
+		int axis = extent.x > extent.y ? (extent.x > extent.z ? 0 : 2) : (extent.y > extent.z ? 1 : 2);
+		int middle = begin + (end - begin) / 2;
+		std::nth_element(indices.begin() + begin, indices.begin() + middle, indices.begin() + end,
+						 [&](int a, int b) { return lights[a][axis] < lights[b][axis]; });
+
+		build(lights, indices, begin, middle);
+		right = build(lights, indices, middle, end);
+	}
+
+	auto &node = nodes[index];
+	node.min = min;
+	node.max = max;
+	node.count = end - begin;
+	node.light = light;
+	node.right = right;
+	return index;
+}
+
+float traceur::LightTree::importance(const traceur::LightTreeNode &node,
+									 const glm::vec3 &position,
+									 const glm::vec3 &normal,
+									 float diffuse,
+									 float specular) const
+{
+	auto center = (node.min + node.max) * 0.5f;
+	float radius = glm::length(node.max - node.min) * 0.5f;
+	auto direction = center - position;
+	float distance = glm::length(direction);
+
+	// Bound the cosine between the normal and the directions towards the
+	// cluster by widening the cone towards its center with the bounding
+	// sphere of the cluster.
+	float cosine = 1.f;
+	if (distance > radius) {
+		float cosTheta = glm::dot(normal, direction) / distance;
+		float sinTheta = std::sqrt(std::max(0.f, 1.f - cosTheta * cosTheta));
+		float sinBound = radius / distance;
+		float cosBound = std::sqrt(std::max(0.f, 1.f - sinBound * sinBound));
+		if (cosTheta < cosBound) {
+			cosine = cosTheta * cosBound + sinTheta * sinBound;
+		}
+	}
+
+	return node.count * (diffuse * std::max(0.f, cosine) + specular);
+}
+
+int traceur::LightTree::sample(const glm::vec3 &position,
+							   const glm::vec3 &normal,
+							   float diffuse,
+							   float specular,
+							   float u,
+							   float &pdf) const
+{
+	pdf = 0.f;
+	if (nodes.empty() || importance(nodes[0], position, normal, diffuse, specular) <= 0) {
+		return -1;
+	}
+
+	pdf = 1.f;
+	int index = 0;
+	while (nodes[index].light < 0) {
+		int left = index + 1;
+		int right = nodes[index].right;
+		float a = importance(nodes[left], position, normal, diffuse, specular);
+		float b = importance(nodes[right], position, normal, diffuse, specular);
+		if (a + b <= 0) {
+			pdf = 0.f;
+			return -1;
+		}
+		float p = a / (a + b);
+
+		// Descend into one of the children and rescale the sample, so it can
+		// be reused at the next level
+		if (u < p) {
+			u = u / p;
+			pdf *= p;
+			index = left;
+		} else {
+			u = (u - p) / (1.f - p);
+			pdf *= 1.f - p;
+			index = right;
+		}
+		u = std::min(u, traceur::oneMinusEpsilon);
+	}
+
+	return nodes[index].light;
+}
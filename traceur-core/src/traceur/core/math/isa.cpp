@@ -0,0 +1,95 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/math/isa.hpp>
+
+namespace {
+	/**
+	 * The instruction set of which the kernels are used.
+	 */
+	traceur::ISA & active()
+	{
+		static traceur::ISA isa = traceur::detect_isa();
+		return isa;
+	}
+}
+
+traceur::ISA traceur::detect_isa()
+{
+#ifdef TRACEUR_ISA_DISPATCH
+	/* These checks include the support of the operating system for the
+	 * extended register state */
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") &&
+		__builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512dq")) {
+		return traceur::ISA::AVX512;
+	}
+	if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+		return traceur::ISA::AVX2;
+	}
+	if (__builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt")) {
+		return traceur::ISA::SSE42;
+	}
+#endif
+	return traceur::ISA::Baseline;
+}
+
+traceur::ISA traceur::active_isa()
+{
+	return active();
+}
+
+bool traceur::force_isa(traceur::ISA isa)
+{
+	if (static_cast<int>(isa) > static_cast<int>(traceur::detect_isa())) {
+		return false;
+	}
+	active() = isa;
+	return true;
+}
+
+const char * traceur::isa_name(traceur::ISA isa)
+{
+	switch (isa) {
+		case traceur::ISA::AVX512:
+			return "avx512";
+		case traceur::ISA::AVX2:
+			return "avx2";
+		case traceur::ISA::SSE42:
+			return "sse4.2";
+		default:
+			return "baseline";
+	}
+}
+
+bool traceur::parse_isa(const std::string &name, traceur::ISA &isa)
+{
+	for (auto candidate : { traceur::ISA::Baseline, traceur::ISA::SSE42, traceur::ISA::AVX2, traceur::ISA::AVX512 }) {
+		if (name == traceur::isa_name(candidate)) {
+			isa = candidate;
+			return true;
+		}
+	}
+	return false;
+}
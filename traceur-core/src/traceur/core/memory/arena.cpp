@@ -0,0 +1,122 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/memory/arena.hpp>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace {
+	/**
+	 * The alignment of a block backed by huge pages.
+	 */
+	const size_t HugePageSize = 2 << 20;
+
+	/**
+	 * Map a block of memory of the given size.
+	 *
+	 * @param[in] size The size of the block in bytes.
+	 * @return A pointer to the block.
+	 */
+	void * map(size_t size)
+	{
+#if defined(__linux__)
+#if USE_HUGE_PAGES && defined(MADV_HUGEPAGE)
+		/* Transparent huge pages are only used for aligned ranges, so
+		 * over-allocate and trim the mapping to a huge page boundary */
+		size_t length = size + HugePageSize;
+		void *data = mmap(nullptr, length, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED) {
+			throw std::bad_alloc();
+		}
+
+		uintptr_t start = reinterpret_cast<uintptr_t>(data);
+		uintptr_t aligned = (start + HugePageSize - 1) & ~(uintptr_t) (HugePageSize - 1);
+		if (aligned > start) {
+			munmap(data, aligned - start);
+		}
+		if (aligned + size < start + length) {
+			munmap(reinterpret_cast<void *>(aligned + size), start + length - aligned - size);
+		}
+
+		madvise(reinterpret_cast<void *>(aligned), size, MADV_HUGEPAGE);
+		return reinterpret_cast<void *>(aligned);
+#else
+		void *data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (data == MAP_FAILED) {
+			throw std::bad_alloc();
+		}
+		return data;
+#endif
+#else
+		return ::operator new(size);
+#endif
+	}
+
+	/**
+	 * Unmap a block of memory that has been mapped by {@link map}.
+	 *
+	 * @param[in] data A pointer to the block.
+	 * @param[in] size The size of the block in bytes.
+	 */
+	void unmap(void *data, size_t size)
+	{
+#if defined(__linux__)
+		munmap(data, size);
+#else
+		::operator delete(data);
+#endif
+	}
+}
+
+traceur::Arena::~Arena()
+{
+	for (auto &block : blocks) {
+		unmap(block.data, block.size);
+	}
+}
+
+void * traceur::Arena::grow(size_t size, size_t alignment)
+{
+	/* Serve allocations larger than a block from a block of their own */
+	size_t required = size + alignment;
+	size_t length = ((required + BlockSize - 1) / BlockSize) * BlockSize;
+
+	void *data = map(length);
+	blocks.push_back({data, length});
+
+	head = reinterpret_cast<uintptr_t>(data);
+	tail = head + length;
+	return allocate(size, alignment);
+}
+
+size_t traceur::Arena::capacity() const
+{
+	size_t size = 0;
+	for (auto &block : blocks) {
+		size += block.size;
+	}
+	return size;
+}
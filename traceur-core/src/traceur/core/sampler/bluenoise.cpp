@@ -0,0 +1,170 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include <traceur/core/sampler/bluenoise.hpp>
+
+namespace {
+	/**
+	 * The energy field of the void-and-cluster method, which is the
+	 * convolution of a binary pattern with a toroidal Gaussian filter.
+	 */
+	class EnergyField {
+	public:
+		EnergyField(int size) : size(size), filter(size * size), energy(size * size, 0.f), pattern(size * size, false)
+		{
+			const float sigma = 1.5f;
+			for (int y = 0; y < size; y++) {
+				for (int x = 0; x < size; x++) {
+					/* Distance on the torus */
+					int dx = std::min(x, size - x);
+					int dy = std::min(y, size - y);
+					filter[y * size + x] = std::exp(-(dx * dx + dy * dy) / (2.f * sigma * sigma));
+				}
+			}
+		}
+
+		/**
+		 * Set or clear a texel of the binary pattern.
+		 */
+		void set(int index, bool value)
+		{
+			if (pattern[index] == value) {
+				return;
+			}
+			pattern[index] = value;
+
+			float sign = value ? 1.f : -1.f;
+			int px = index % size;
+			int py = index / size;
+			for (int y = 0; y < size; y++) {
+				int fy = (y - py + size) % size;
+				for (int x = 0; x < size; x++) {
+					int fx = (x - px + size) % size;
+					energy[y * size + x] += sign * filter[fy * size + fx];
+				}
+			}
+		}
+
+		/**
+		 * Return the set texel with the highest energy.
+		 */
+		int tightestCluster() const
+		{
+			int best = -1;
+			for (int i = 0; i < size * size; i++) {
+				if (pattern[i] && (best < 0 || energy[i] > energy[best])) {
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		/**
+		 * Return the clear texel with the lowest energy.
+		 */
+		int largestVoid() const
+		{
+			int best = -1;
+			for (int i = 0; i < size * size; i++) {
+				if (!pattern[i] && (best < 0 || energy[i] < energy[best])) {
+					best = i;
+				}
+			}
+			return best;
+		}
+
+		const int size;
+		std::vector<float> filter;
+		std::vector<float> energy;
+		std::vector<bool> pattern;
+	};
+}
+
+const traceur::BlueNoiseTile & traceur::BlueNoiseTile::instance()
+{
+	static const traceur::BlueNoiseTile tile;
+	return tile;
+}
+
+traceur::BlueNoiseTile::BlueNoiseTile() : values(size * size)
+{
+	const int texels = size * size;
+	const int initial = texels / 10;
+	std::vector<int> ranks(texels, -1);
+	EnergyField field(size);
+
+	/* Create an initial pattern of random texels */
+	for (int i = 0, n = 0; n < initial; i++) {
+		int index = static_cast<int>(traceur::hash(i, 0x626e) % texels);
+		if (!field.pattern[index]) {
+			field.set(index, true);
+			n++;
+		}
+	}
+
+	/* Move texels from the tightest cluster into the largest void until stable */
+	for (int i = 0; i < texels; i++) {
+		int cluster = field.tightestCluster();
+		field.set(cluster, false);
+		int hole = field.largestVoid();
+		field.set(hole, true);
+
+		if (hole == cluster) {
+			break;
+		}
+	}
+
+	/* Rank the texels of the initial pattern by removing the tightest clusters */
+	EnergyField prototype = field;
+	for (int rank = initial - 1; rank >= 0; rank--) {
+		int cluster = field.tightestCluster();
+		field.set(cluster, false);
+		ranks[cluster] = rank;
+	}
+
+	/* Rank the remaining texels by filling the largest voids */
+	for (int rank = initial; rank < texels; rank++) {
+		int hole = prototype.largestVoid();
+		prototype.set(hole, true);
+		ranks[hole] = rank;
+	}
+
+	for (int i = 0; i < texels; i++) {
+		values[i] = (ranks[i] + 0.5f) / texels;
+	}
+}
+
+float traceur::BlueNoiseSampler::sample(const glm::ivec2 &pixel, uint32_t index, uint32_t dimension) const
+{
+	/* Offset the tile per dimension, so that the dimensions are not correlated */
+	uint32_t offset = traceur::hash(dimension, 0x626e);
+	float rotation = tile(pixel.x + static_cast<int>(offset & 0xffff), pixel.y + static_cast<int>(offset >> 16));
+	float value = sampler->sample(glm::ivec2(0, 0), index, dimension) + rotation;
+	value -= value >= 1.f ? 1.f : 0.f;
+	return std::min(value, traceur::oneMinusEpsilon);
+}
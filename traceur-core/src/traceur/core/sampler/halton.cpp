@@ -0,0 +1,82 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <algorithm>
+
+#include <traceur/core/sampler/halton.hpp>
+
+namespace {
+	/**
+	 * The prime bases of the dimensions of the sequence.
+	 */
+	const uint32_t primes[] = {
+		2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53,
+		59, 61, 67, 71, 73, 79, 83, 89, 97, 101, 103, 107, 109, 113, 127, 131
+	};
+
+	/**
+	 * The amount of supported bases.
+	 */
+	const uint32_t bases = sizeof(primes) / sizeof(primes[0]);
+
+	/**
+	 * Compute the radical inverse of the given index in the given base.
+	 *
+	 * @param[in] index The index to invert.
+	 * @param[in] base The base to use.
+	 * @return The radical inverse in the range [0, 1).
+	 */
+	inline double radicalInverse(uint32_t index, uint32_t base)
+	{
+		double inverse = 1.0 / base;
+		double factor = inverse;
+		double result = 0.0;
+
+		while (index > 0) {
+			result += (index % base) * factor;
+			index /= base;
+			factor *= inverse;
+		}
+		return result;
+	}
+}
+
+float traceur::HaltonSampler::sample(const glm::ivec2 &pixel, uint32_t index, uint32_t dimension) const
+{
+	uint32_t seed = traceur::hash(pixel);
+
+	/* Shuffle the order of the points for every wrap of the bases, since the
+	 * dimensions of a base would otherwise only differ by their rotation */
+	uint32_t wrap = dimension / bases;
+	if (wrap > 0) {
+		index = traceur::owen_scramble(index, traceur::hash(seed, wrap));
+	}
+	double value = radicalInverse(index, primes[dimension % bases]);
+
+	/* Rotate the sequence per pixel and dimension */
+	double rotation = traceur::fraction(traceur::hash(seed, dimension));
+	value += rotation;
+	value -= value >= 1.0 ? 1.0 : 0.0;
+	return std::min(static_cast<float>(value), traceur::oneMinusEpsilon);
+}
@@ -0,0 +1,45 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/sampler/sampler.hpp>
+#include <traceur/core/sampler/independent.hpp>
+#include <traceur/core/sampler/halton.hpp>
+#include <traceur/core/sampler/sobol.hpp>
+#include <traceur/core/sampler/bluenoise.hpp>
+
+std::shared_ptr<traceur::Sampler> traceur::make_sampler(const std::string &name)
+{
+	if (name == "independent") {
+		return std::make_shared<traceur::IndependentSampler>();
+	} else if (name == "halton") {
+		return std::make_shared<traceur::HaltonSampler>();
+	} else if (name == "sobol") {
+		return std::make_shared<traceur::SobolSampler>(false);
+	} else if (name == "owen") {
+		return std::make_shared<traceur::SobolSampler>(true);
+	} else if (name == "bluenoise") {
+		return std::make_shared<traceur::BlueNoiseSampler>(std::make_shared<traceur::SobolSampler>(true));
+	}
+	return nullptr;
+}
@@ -0,0 +1,112 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/sampler/sobol.hpp>
+
+namespace {
+	/**
+	 * The amount of dimensions of the underlying Sobol sequence.
+	 */
+	const uint32_t dimensions = 4;
+
+	/**
+	 * The generator matrices of the first dimensions of the Sobol sequence,
+	 * stored as one column (direction number) per bit.
+	 */
+	struct Matrices {
+		uint32_t columns[dimensions][32];
+
+		Matrices()
+		{
+			/*
+			 * The degree, coefficients and initial direction numbers of the
+			 * primitive polynomials of dimension 1 to 3 (Joe and Kuo, 2008).
+			 * Dimension 0 is the van der Corput sequence.
+			 */
+			const uint32_t degree[] = {0, 1, 2, 3};
+			const uint32_t coefficients[] = {0, 0, 1, 1};
+			const uint32_t initial[][3] = {{0, 0, 0}, {1, 0, 0}, {1, 3, 0}, {1, 3, 1}};
+
+			for (uint32_t bit = 0; bit < 32; bit++) {
+				columns[0][bit] = 1u << (31 - bit);
+			}
+
+			for (uint32_t d = 1; d < dimensions; d++) {
+				uint32_t s = degree[d];
+				uint32_t v[32];
+
+				for (uint32_t i = 0; i < s; i++) {
+					v[i] = initial[d][i] << (31 - i);
+				}
+
+				for (uint32_t i = s; i < 32; i++) {
+					v[i] = v[i - s] ^ (v[i - s] >> s);
+					for (uint32_t k = 1; k < s; k++) {
+						v[i] ^= ((coefficients[d] >> (s - 1 - k)) & 1u) * v[i - k];
+					}
+				}
+
+				for (uint32_t bit = 0; bit < 32; bit++) {
+					columns[d][bit] = v[bit];
+				}
+			}
+		}
+	};
+
+	/**
+	 * The generator matrices of the sequence.
+	 */
+	const Matrices matrices;
+}
+
+uint32_t traceur::SobolSampler::sobol(uint32_t index, uint32_t dimension)
+{
+	uint32_t result = 0;
+	for (uint32_t bit = 0; index; index >>= 1, bit++) {
+		result ^= (index & 1u) * matrices.columns[dimension][bit];
+	}
+	return result;
+}
+
+uint32_t traceur::SobolSampler::blockSize() const
+{
+	return dimensions;
+}
+
+float traceur::SobolSampler::sample(const glm::ivec2 &pixel, uint32_t index, uint32_t dimension) const
+{
+	uint32_t seed = traceur::hash(pixel);
+
+	/* Shuffle the order of the points for every block of padded dimensions */
+	uint32_t block = traceur::hash(seed, dimension / dimensions);
+	uint32_t shuffled = traceur::owen_scramble(index, block);
+	uint32_t value = sobol(shuffled, dimension % dimensions);
+
+	if (scrambled) {
+		value = traceur::owen_scramble(value, traceur::hash(block, dimension));
+	} else {
+		value ^= traceur::hash(block, dimension);
+	}
+	return traceur::fraction(value);
+}
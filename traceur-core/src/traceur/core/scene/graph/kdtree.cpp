@@ -23,64 +23,114 @@
  */
 
 #include <traceur/core/scene/graph/kdtree.hpp>
+#include <traceur/core/math/isa.hpp>
+#include <algorithm>
 #include <glm/gtx/string_cast.hpp>
 #include <iostream>
 
+namespace {
+	/**
+	 * A visitor that sorts the primitives of a leaf by their concrete type.
+	 */
+	class LeafVisitor : public traceur::SceneGraphVisitor {
+	public:
+		using traceur::SceneGraphVisitor::visit;
 
-bool traceur::KDTreeNode::intersect(const traceur::Ray &ray, traceur::Hit &hit) const
-{
-	/* Test if ray intersects the bounding box of the scene graph */
-	if (!box.intersect(ray, hit)) {
-		return false;
-	}
-
+		/**
+		 * The primitive that is currently visited.
+		 */
+		std::shared_ptr<traceur::Primitive> primitive;
 
-	traceur::Hit nearest;
-	double dist = std::numeric_limits<double>::infinity();
-	bool intersection = false;
+		/**
+		 * The primitives that have been visited, grouped by their type.
+		 */
+		std::vector<traceur::Triangle> triangles;
+		std::vector<traceur::Sphere> spheres;
+		std::vector<traceur::Box> boxes;
+		std::vector<std::shared_ptr<traceur::Primitive>> primitives;
 
-	/* If the node has left or right nodes, test for intersection on these */
-	for (auto node : {&*left, &*right}) {
-		/* Test if the ray intersects the node */
-		if (node && node->intersect(ray, hit) && hit.distance < dist) {
-			nearest = hit;
-			dist = hit.distance;
-			intersection = true;
+		virtual void visit(const traceur::Primitive &) final
+		{
+			primitives.push_back(primitive);
 		}
-	}
 
-	if (intersection) {
-		hit = nearest;
-		return true;
-	}
+		virtual void visit(const traceur::Sphere &sphere) final
+		{
+			spheres.push_back(sphere);
+		}
 
-	for (auto &primitive : primitives) {
-		/* Test if ray intersects bounding box of primitive */
-		if (!primitive->bounding_box().intersect(ray, hit)) {
-			continue;
+		virtual void visit(const traceur::Triangle &triangle) final
+		{
+			triangles.push_back(triangle);
 		}
 
-		/* Test if ray intersects primitive */
-		if (primitive->intersect(ray, hit) && hit.distance < dist) {
-			nearest = hit;
-			dist = hit.distance;
-			intersection = true;
+		virtual void visit(const traceur::Box &box) final
+		{
+			boxes.push_back(box);
 		}
+	};
+
+	/**
+	 * Determine the nearest hit of each ray of a batch, with the traversal
+	 * of the tree compiled for the given instruction set.
+	 *
+	 * @tparam I The instruction set to compile the traversal for.
+	 */
+	template<traceur::ISA I>
+	void intersect_batch(const traceur::KDTreeNode &root,
+						 const traceur::Ray *rays,
+						 traceur::Hit *hits,
+						 size_t count)
+	{
+		traceur::Target<I>::invoke([&]() {
+			for (size_t i = 0; i < count; i++) {
+				if (root.intersect(rays[i], hits[i])) {
+					hits[i].primitive->finalize(rays[i], hits[i]);
+				} else {
+					hits[i].primitive = nullptr;
+				}
+			}
+		});
 	}
 
-	if (intersection) {
-		hit = nearest;
-		return true;
+	/**
+	 * Determine for each ray of a batch whether it is occluded, with the
+	 * traversal of the tree compiled for the given instruction set.
+	 *
+	 * @tparam I The instruction set to compile the traversal for.
+	 */
+	template<traceur::ISA I>
+	void occluded_batch(const traceur::KDTreeNode &root,
+						const traceur::Ray *rays,
+						const float *distances,
+						bool *results,
+						size_t count)
+	{
+		traceur::Target<I>::invoke([&]() {
+			for (size_t i = 0; i < count; i++) {
+				results[i] = root.occluded(rays[i], distances[i]);
+			}
+		});
 	}
-	return false;
 }
 
-
 void traceur::KDTreeNode::accept(traceur::SceneGraphVisitor &visitor) const
 {
 	visitor.visit(*this);
 
-	for (auto &primitive : primitives) {
+	for (auto &triangle : triangles) {
+		triangle.accept(visitor);
+	}
+
+	for (auto &sphere : spheres) {
+		sphere.accept(visitor);
+	}
+
+	for (auto &box : boxes) {
+		box.accept(visitor);
+	}
+
+	for (auto primitive : primitives) {
 		primitive->accept(visitor);
 	}
 
@@ -93,11 +143,6 @@ void traceur::KDTreeNode::accept(traceur::SceneGraphVisitor &visitor) const
 	}
 }
 
-bool traceur::KDTreeSceneGraph::intersect(const traceur::Ray &ray, traceur::Hit &hit) const
-{
-	return root->intersect(ray, hit);
-}
-
 void traceur::KDTreeSceneGraph::accept(traceur::SceneGraphVisitor &visitor) const
 {
 	return root->accept(visitor);
@@ -105,27 +150,30 @@ void traceur::KDTreeSceneGraph::accept(traceur::SceneGraphVisitor &visitor) cons
 
 void traceur::KDTreeSceneGraphBuilder::add(const std::shared_ptr<traceur::Primitive> primitive)
 {
+	primitive->id = static_cast<uint32_t>(primitives.size());
 	primitives.push_back(primitive);
 }
 
 
-std::unique_ptr<traceur::KDTreeNode> traceur::KDTreeSceneGraphBuilder::build(
+traceur::KDTreeNode * traceur::KDTreeSceneGraphBuilder::build(
 	const std::vector<std::shared_ptr<traceur::Primitive>> &primitives,
-	int depth) const
+	int depth,
+	traceur::Arena &arena,
+	std::vector<std::shared_ptr<traceur::Primitive>> &owners) const
 {
-	std::unique_ptr<traceur::KDTreeNode> node = std::make_unique<traceur::KDTreeNode>();
-	node->primitives = primitives;
+	traceur::KDTreeNode *node = arena.create<traceur::KDTreeNode>();
 	node->depth = depth;
 
 	/* Optimize for small trees */
 	if (primitives.size() == 0) {
-		node->box = traceur::Box(std::make_shared<traceur::Material>());
-		return std::move(node);
+		node->box = traceur::AABB();
+		node->bounds = traceur::AlignedBox(node->box);
+		return node;
 	} else if (primitives.size() == 1) {
 		auto &primitive = primitives[0];
 		node->origin = primitive->origin;
 		node->box = primitive->bounding_box();
-		return std::move(node);
+		return leaf(node, primitives, arena, owners);
 	}
 
 	/* Calculate the bounding box and origin for this node */
@@ -135,8 +183,8 @@ std::unique_ptr<traceur::KDTreeNode> traceur::KDTreeSceneGraphBuilder::build(
 	}
 
 	/* Do not create too small nodes */
-	if (depth > 5 || primitives.size() <= 100) {
-		return std::move(node);
+	if (depth >= traceur::KDTreeNode::MaximumDepth || primitives.size() <= 100) {
+		return leaf(node, primitives, arena, owners);
 	}
 
 	int axis = static_cast<int>(node->bounding_box().longestAxis());
@@ -152,14 +200,59 @@ std::unique_ptr<traceur::KDTreeNode> traceur::KDTreeSceneGraphBuilder::build(
 		}
 	}
 
-	node->left = std::move(build(left, depth + 1));
-	node->right = std::move(build(right, depth + 1));
-	return std::move(node);
+	node->left = build(left, depth + 1, arena, owners);
+	node->right = build(right, depth + 1, arena, owners);
+	node->bounds = traceur::AlignedBox(node->box);
+	return node;
+}
+
+traceur::KDTreeNode * traceur::KDTreeSceneGraphBuilder::leaf(
+	traceur::KDTreeNode *node,
+	const std::vector<std::shared_ptr<traceur::Primitive>> &primitives,
+	traceur::Arena &arena,
+	std::vector<std::shared_ptr<traceur::Primitive>> &owners) const
+{
+	LeafVisitor visitor;
+	node->bounds = traceur::AlignedBox(node->box);
+
+	for (auto &primitive : primitives) {
+		visitor.primitive = primitive;
+		primitive->accept(visitor);
+	}
+
+	/* Copy the primitives next to each other into the arena of the tree */
+	node->triangles = arena.array(visitor.triangles);
+
+	if (intersector == traceur::TriangleIntersector::Transform) {
+		std::vector<traceur::TriangleTransform> transforms(visitor.triangles.begin(), visitor.triangles.end());
+		std::vector<traceur::TrianglePacket> packets;
+
+		for (size_t i = 0; i < transforms.size(); i += traceur::TrianglePacket::Width) {
+			int count = std::min<size_t>(traceur::TrianglePacket::Width, transforms.size() - i);
+			packets.push_back(traceur::TrianglePacket(&transforms[i], count));
+		}
+		node->packets = arena.array(packets);
+	}
+	node->spheres = arena.array(visitor.spheres);
+	node->boxes = arena.array(visitor.boxes);
+
+	/* Primitives of other types are referenced and kept alive by the tree */
+	std::vector<const traceur::Primitive *> references;
+	for (auto &primitive : visitor.primitives) {
+		references.push_back(primitive.get());
+		owners.push_back(primitive);
+	}
+	node->primitives = arena.array(references);
+	return node;
 }
 
 std::unique_ptr<traceur::SceneGraph> traceur::KDTreeSceneGraphBuilder::build() const
 {
-	return std::make_unique<traceur::KDTreeSceneGraph>(build(primitives, 0), primitives.size());
+	auto arena = std::make_shared<traceur::Arena>();
+	std::vector<std::shared_ptr<traceur::Primitive>> owners;
+	auto root = build(primitives, 0, *arena, owners);
+
+	return std::make_unique<traceur::KDTreeSceneGraph>(std::move(arena), root, std::move(owners), primitives.size());
 }
 
 size_t traceur::KDTreeSceneGraph::size() const
@@ -167,3 +260,33 @@ size_t traceur::KDTreeSceneGraph::size() const
 	return nodes;
 }
 
+void traceur::KDTreeSceneGraph::intersect(const traceur::Ray *rays, traceur::Hit *hits, size_t count) const
+{
+	typedef void (*Batch)(const traceur::KDTreeNode &, const traceur::Ray *, traceur::Hit *, size_t);
+#ifdef TRACEUR_ISA_DISPATCH
+	Batch batch = traceur::dispatch<Batch>(intersect_batch<traceur::ISA::Baseline>,
+										   intersect_batch<traceur::ISA::SSE42>,
+										   intersect_batch<traceur::ISA::AVX2>,
+										   intersect_batch<traceur::ISA::AVX512>);
+#else
+	Batch batch = intersect_batch<traceur::ISA::Baseline>;
+#endif
+	batch(*root, rays, hits, count);
+}
+
+void traceur::KDTreeSceneGraph::occluded(const traceur::Ray *rays,
+										 const float *distances,
+										 bool *results,
+										 size_t count) const
+{
+	typedef void (*Batch)(const traceur::KDTreeNode &, const traceur::Ray *, const float *, bool *, size_t);
+#ifdef TRACEUR_ISA_DISPATCH
+	Batch batch = traceur::dispatch<Batch>(occluded_batch<traceur::ISA::Baseline>,
+										   occluded_batch<traceur::ISA::SSE42>,
+										   occluded_batch<traceur::ISA::AVX2>,
+										   occluded_batch<traceur::ISA::AVX512>);
+#else
+	Batch batch = occluded_batch<traceur::ISA::Baseline>;
+#endif
+	batch(*root, rays, distances, results, count);
+}
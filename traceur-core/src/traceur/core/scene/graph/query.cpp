@@ -0,0 +1,75 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+#include <traceur/core/scene/graph/query.hpp>
+#include <algorithm>
+
+traceur::RayQueryEngine::RayQueryEngine(int workers, size_t chunkSize)
+	: workers(workers), chunkSize(chunkSize), pool(workers) {}
+
+void traceur::RayQueryEngine::intersect(const traceur::SceneGraph &graph,
+										const traceur::Ray *rays,
+										traceur::Hit *hits,
+										size_t count) const
+{
+	run(count, [&](size_t first, size_t size) {
+		graph.intersect(rays + first, hits + first, size);
+	});
+}
+
+void traceur::RayQueryEngine::occluded(const traceur::SceneGraph &graph,
+									   const traceur::Ray *rays,
+									   const float *distances,
+									   bool *results,
+									   size_t count) const
+{
+	run(count, [&](size_t first, size_t size) {
+		graph.occluded(rays + first, distances + first, results + first, size);
+	});
+}
+
+void traceur::RayQueryEngine::run(size_t count, const std::function<void(size_t, size_t)> &query) const
+{
+	size_t chunk = std::max<size_t>(chunkSize, 1);
+
+	/* Small batches do not make up for the synchronisation */
+	if (workers <= 0 || count <= chunk) {
+		query(0, count);
+		return;
+	}
+
+	auto jobs = std::queue<std::future<void>>();
+	for (size_t first = 0; first < count; first += chunk) {
+		size_t size = std::min(chunk, count - first);
+		jobs.emplace(pool.enqueue([&query, first, size]() {
+			query(first, size);
+		}));
+	}
+
+	/* Wait for all chunks to finish */
+	while (!jobs.empty()) {
+		jobs.front().wait();
+		jobs.pop();
+	}
+}
@@ -26,38 +26,6 @@
 #include <iostream>
 #include <glm/gtx/string_cast.hpp>
 
-bool traceur::VectorSceneGraph::intersect(const traceur::Ray &ray,
-										  traceur::Hit &hit) const
-{
-	/* Test if ray intersects the bounding box of the scene graph */
-	if (!box.intersect(ray, hit)) {
-		return false;
-	}
-
-	traceur::Hit nearest;
-	double dist = std::numeric_limits<double>::infinity();
-	bool intersection = false;
-
-	for (auto &primitive : nodes) {
-		/* Test if ray intersects bounding box of primitive */
-		if (!primitive->bounding_box().intersect(ray, hit)) {
-			continue;
-		}
-
-		/* Test if ray intersects primitive */
-		if (primitive->intersect(ray, hit) && hit.distance < dist) {
-			nearest = hit;
-			dist = hit.distance;
-			intersection = true;
-		}
-	}
-
-	if (intersection) {
-		hit = nearest;
-	}
-	return intersection;
-}
-
 void traceur::VectorSceneGraph::accept(traceur::SceneGraphVisitor &visitor) const
 {
 	/* Visit the root node */
@@ -75,6 +43,7 @@ size_t traceur::VectorSceneGraph::size() const
 
 void traceur::VectorSceneGraphBuilder::add(const std::shared_ptr<traceur::Primitive> primitive)
 {
+	primitive->id = static_cast<uint32_t>(nodes.size());
 	nodes.push_back(primitive);
 	box = box.expand(primitive->bounding_box());
 }
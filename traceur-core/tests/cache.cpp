@@ -0,0 +1,226 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <cmath>
+#include <memory>
+
+#include <check.hpp>
+#include <traceur/core/lightning/cache.hpp>
+#include <traceur/core/scene/scene.hpp>
+#include <traceur/core/scene/graph/vector.hpp>
+#include <traceur/core/scene/primitive/triangle.hpp>
+
+namespace {
+	/**
+	 * The normal of the floor of the scene.
+	 */
+	const glm::vec3 up(0, 1, 0);
+
+	/**
+	 * Create a scene that spans the cube [0, 8]^3, so a cache with a
+	 * resolution of 8 has cells of unit size.
+	 *
+	 * @return The scene.
+	 */
+	traceur::Scene make_scene()
+	{
+		traceur::VectorSceneGraphBuilder builder;
+		builder.add(std::make_shared<traceur::Triangle>(glm::vec3(0, 0, 0), glm::vec3(8, 0, 0), glm::vec3(0, 0, 8), 0));
+		builder.add(std::make_shared<traceur::Triangle>(glm::vec3(0, 8, 0), glm::vec3(8, 0, 0), glm::vec3(0, 0, 8), 0));
+
+		traceur::Scene scene(std::shared_ptr<traceur::SceneGraph>(builder.build()));
+		scene.lights.push_back(glm::vec3(4, 7, 4));
+		scene.lights.push_back(glm::vec3(1, 7, 1));
+		return scene;
+	}
+
+	/**
+	 * Return the center of a cell on the floor of the scene.
+	 *
+	 * @param[in] x The column of the cell.
+	 * @param[in] z The row of the cell.
+	 * @return The center of the cell.
+	 */
+	glm::vec3 floor_cell(int x, int z)
+	{
+		return glm::vec3(x + 0.5f, 0.25f, z + 0.5f);
+	}
+
+	/**
+	 * Determine whether a lookup hits with the expected visibility.
+	 *
+	 * @param[in] cache The cache to look up the visibility in.
+	 * @param[in] position The position of the lookup.
+	 * @param[in] normal The normal of the lookup.
+	 * @param[in] light The light of the lookup.
+	 * @param[in] expected The expected visibility.
+	 * @return <code>true</code> if the lookup hits with the expected
+	 * visibility, otherwise <code>false</code>.
+	 */
+	bool hits(const traceur::VisibilityCache &cache, const glm::vec3 &position,
+			  const glm::vec3 &normal, size_t light, float expected)
+	{
+		float visibility = -1.f;
+		return cache.lookup(position, normal, light, visibility)
+			&& std::fabs(visibility - expected) < 1e-4f;
+	}
+
+	/**
+	 * Determine whether a lookup misses.
+	 *
+	 * @param[in] cache The cache to look up the visibility in.
+	 * @param[in] position The position of the lookup.
+	 * @param[in] normal The normal of the lookup.
+	 * @param[in] light The light of the lookup.
+	 * @return <code>true</code> if the lookup misses, otherwise
+	 * <code>false</code>.
+	 */
+	bool misses(const traceur::VisibilityCache &cache, const glm::vec3 &position,
+				const glm::vec3 &normal, size_t light)
+	{
+		float visibility;
+		return !cache.lookup(position, normal, light, visibility);
+	}
+
+	void check_detached()
+	{
+		traceur::VisibilityCache cache(8, 0.05f, 1024);
+		cache.store(floor_cell(2, 2), up, 0, 1.f);
+		cache.store(floor_cell(3, 2), up, 0, 1.f);
+		TRACEUR_CHECK(misses(cache, glm::vec3(3, 0.25f, 2.5f), up, 0));
+	}
+
+	void check_interpolation()
+	{
+		traceur::Scene scene = make_scene();
+		traceur::VisibilityCache cache(8, 0.1f, 1024);
+		cache.attach(scene);
+
+		/* A single cell is not confirmed by a neighbour */
+		cache.store(floor_cell(2, 2), up, 0, 0.5f);
+		TRACEUR_CHECK(misses(cache, glm::vec3(3, 0.25f, 3), up, 0));
+
+		cache.store(floor_cell(3, 2), up, 0, 0.52f);
+		cache.store(floor_cell(2, 3), up, 0, 0.54f);
+		cache.store(floor_cell(3, 3), up, 0, 0.56f);
+
+		/* The centers of the cells return their own visibility and the
+		 * corner between them the average */
+		TRACEUR_CHECK(hits(cache, floor_cell(2, 2), up, 0, 0.5f));
+		TRACEUR_CHECK(hits(cache, glm::vec3(3, 0.25f, 3), up, 0, 0.53f));
+		TRACEUR_CHECK(hits(cache, glm::vec3(3, 0.25f, 2.5f), up, 0, 0.51f));
+
+		/* The entries are separate per light, orientation and layer */
+		TRACEUR_CHECK(misses(cache, glm::vec3(3, 0.25f, 3), up, 1));
+		TRACEUR_CHECK(misses(cache, glm::vec3(3, 0.25f, 3), -up, 0));
+		TRACEUR_CHECK(misses(cache, glm::vec3(3, 1.25f, 3), up, 0));
+
+		/* Replacing an entry keeps a single entry for its key */
+		cache.store(floor_cell(2, 2), up, 0, 0.6f);
+		TRACEUR_CHECK(hits(cache, floor_cell(2, 2), up, 0, 0.6f));
+
+		cache.clear();
+		TRACEUR_CHECK(misses(cache, floor_cell(2, 2), up, 0));
+	}
+
+	void check_tolerance()
+	{
+		traceur::Scene scene = make_scene();
+		traceur::VisibilityCache cache(8, 0.05f, 1024);
+		cache.attach(scene);
+
+		/* The cells around the edge of a shadow disagree */
+		cache.store(floor_cell(5, 5), up, 1, 0.f);
+		cache.store(floor_cell(6, 5), up, 1, 1.f);
+		TRACEUR_CHECK(misses(cache, glm::vec3(6, 0.25f, 5.5f), up, 1));
+	}
+
+	void check_generation()
+	{
+		traceur::Scene scene = make_scene();
+		traceur::VisibilityCache cache(8, 0.05f, 1024);
+		cache.attach(scene);
+		cache.store(floor_cell(2, 2), up, 0, 1.f);
+		cache.store(floor_cell(3, 2), up, 0, 1.f);
+		glm::vec3 position(3, 0.25f, 2.5f);
+		TRACEUR_CHECK(hits(cache, position, up, 0, 1.f));
+
+		/* Attaching the same scene keeps the cached visibility */
+		cache.attach(scene);
+		TRACEUR_CHECK(hits(cache, position, up, 0, 1.f));
+
+		/* A changed scene discards it */
+		scene.invalidate();
+		cache.attach(scene);
+		TRACEUR_CHECK(misses(cache, position, up, 0));
+
+		cache.store(floor_cell(2, 2), up, 0, 1.f);
+		cache.store(floor_cell(3, 2), up, 0, 1.f);
+		TRACEUR_CHECK(hits(cache, position, up, 0, 1.f));
+
+		/* As do moved lights */
+		scene.lights[0] = glm::vec3(4, 6, 4);
+		cache.attach(scene);
+		TRACEUR_CHECK(misses(cache, position, up, 0));
+
+		/* And another scene, even with the same contents */
+		cache.store(floor_cell(2, 2), up, 0, 1.f);
+		cache.store(floor_cell(3, 2), up, 0, 1.f);
+		traceur::Scene other = make_scene();
+		other.lights = scene.lights;
+		cache.attach(other);
+		TRACEUR_CHECK(misses(cache, position, up, 0));
+	}
+
+	void check_capacity()
+	{
+		/* Filling a small cache evicts entries, but never returns the
+		 * visibility of another key */
+		traceur::Scene scene = make_scene();
+		traceur::VisibilityCache cache(8, 0.5f, 16);
+		cache.attach(scene);
+		for (int z = 0; z < 8; z++) {
+			for (int x = 0; x < 8; x++) {
+				cache.store(floor_cell(x, z), up, 0, (x + z) % 2 ? 0.25f : 0.75f);
+			}
+		}
+		for (int z = 0; z < 8; z++) {
+			for (int x = 0; x < 8; x++) {
+				float visibility;
+				if (cache.lookup(floor_cell(x, z), up, 0, visibility)) {
+					TRACEUR_CHECK(std::fabs(visibility - ((x + z) % 2 ? 0.25f : 0.75f)) < 1e-4f);
+				}
+			}
+		}
+	}
+}
+
+int main()
+{
+	check_detached();
+	check_interpolation();
+	check_tolerance();
+	check_generation();
+	check_capacity();
+	return TRACEUR_CHECK_STATUS;
+}
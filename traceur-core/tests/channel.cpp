@@ -0,0 +1,140 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+
+#include <check.hpp>
+#include <traceur/core/kernel/channel.hpp>
+
+namespace {
+	/**
+	 * Construct a float from its bits.
+	 *
+	 * @param[in] bits The bits of the float.
+	 * @return The float.
+	 */
+	float from_bits(uint32_t bits)
+	{
+		float value;
+		std::memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+
+	void check_values()
+	{
+		TRACEUR_CHECK(traceur::pack_half(0.f) == 0x0000u);
+		TRACEUR_CHECK(traceur::pack_half(-0.f) == 0x8000u);
+		TRACEUR_CHECK(traceur::pack_half(1.f) == 0x3c00u);
+		TRACEUR_CHECK(traceur::pack_half(-2.f) == 0xc000u);
+		TRACEUR_CHECK(traceur::pack_half(0.5f) == 0x3800u);
+		TRACEUR_CHECK(traceur::pack_half(65504.f) == 0x7bffu);
+		TRACEUR_CHECK(traceur::pack_half(std::ldexp(1.f, -14)) == 0x0400u);
+
+		/* Halfway values round away from zero, which may carry into the
+		 * exponent */
+		TRACEUR_CHECK(traceur::pack_half(1.f + std::ldexp(1.f, -11)) == 0x3c01u);
+		TRACEUR_CHECK(traceur::pack_half(1.f + std::ldexp(1.f, -12)) == 0x3c00u);
+		TRACEUR_CHECK(traceur::pack_half(2.f - std::ldexp(1.f, -12)) == 0x4000u);
+
+		/* Numbers outside the range of normalized halves */
+		const float inf = std::numeric_limits<float>::infinity();
+		TRACEUR_CHECK(traceur::pack_half(65520.f) == 0x7c00u);
+		TRACEUR_CHECK(traceur::pack_half(1e6f) == 0x7c00u);
+		TRACEUR_CHECK(traceur::pack_half(-1e6f) == 0xfc00u);
+		TRACEUR_CHECK(traceur::pack_half(inf) == 0x7c00u);
+		TRACEUR_CHECK(traceur::pack_half(-inf) == 0xfc00u);
+		TRACEUR_CHECK(traceur::pack_half(1e-8f) == 0x0000u);
+		TRACEUR_CHECK(traceur::pack_half(-1e-8f) == 0x8000u);
+	}
+
+	void check_nan()
+	{
+		/* Also the NaNs of which the payload lies below the mantissa of a
+		 * half stay NaNs */
+		for (uint32_t bits : { 0x7fc00000u, 0x7f800001u, 0x7f801fffu, 0x7fffffffu, 0xffc00000u, 0xff800001u }) {
+			uint16_t half = traceur::pack_half(from_bits(bits));
+			TRACEUR_CHECK((half & 0x7c00u) == 0x7c00u && (half & 0x3ffu) != 0);
+			TRACEUR_CHECK((half & 0x8000u) == ((bits >> 16) & 0x8000u));
+			TRACEUR_CHECK(std::isnan(traceur::unpack_half(half)));
+		}
+	}
+
+	void check_round_trip()
+	{
+		/* Every half survives a round trip through single precision, except
+		 * subnormals, which are flushed to zero, and signalling NaNs, which
+		 * become quiet */
+		for (uint32_t bits = 0; bits <= 0xffffu; bits++) {
+			uint16_t half = static_cast<uint16_t>(bits);
+			float value = traceur::unpack_half(half);
+			uint16_t exponent = (half >> 10) & 0x1fu;
+			uint16_t mantissa = half & 0x3ffu;
+
+			if (exponent == 0 && mantissa != 0) {
+				TRACEUR_CHECK(value == 0.f);
+				TRACEUR_CHECK(std::signbit(value) == ((half & 0x8000u) != 0));
+			} else if (exponent == 31 && mantissa != 0) {
+				TRACEUR_CHECK(std::isnan(value));
+				TRACEUR_CHECK(traceur::pack_half(value) == (half | 0x0200u));
+			} else {
+				TRACEUR_CHECK(traceur::pack_half(value) == half);
+			}
+		}
+	}
+
+	void check_error()
+	{
+		/* The packed value lies within half a unit in the last place */
+		std::mt19937 random(50);
+		for (int i = 0; i < 100000; i++) {
+			float value = std::ldexp(1.f + (random() >> 8) * (1.f / 16777216.f), static_cast<int>(random() % 30) - 14);
+			if (value > 65504.f) {
+				continue;
+			}
+			float ulp = std::ldexp(1.f, std::ilogb(value) - 10);
+			float error = std::fabs(traceur::unpack_half(traceur::pack_half(value)) - value);
+			TRACEUR_CHECK(error <= ulp / 2);
+		}
+	}
+
+	void check_normal()
+	{
+		glm::vec3 normal = glm::normalize(glm::vec3(0.3f, -0.8f, 0.1f));
+		glm::vec3 stored = traceur::HalfNormal(normal);
+		TRACEUR_CHECK(glm::length(stored - normal) < 1e-3f);
+		TRACEUR_CHECK(glm::vec3(traceur::HalfNormal()) == glm::vec3(0.f));
+	}
+}
+
+int main()
+{
+	check_values();
+	check_nan();
+	check_round_trip();
+	check_error();
+	check_normal();
+	return TRACEUR_CHECK_STATUS;
+}
@@ -0,0 +1,59 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#ifndef TRACEUR_CORE_TESTS_CHECK_H
+#define TRACEUR_CORE_TESTS_CHECK_H
+
+#include <cstdio>
+
+namespace traceur {
+	/**
+	 * Return the amount of checks that failed in this test.
+	 *
+	 * @return A reference to the amount of failed checks.
+	 */
+	inline int & failed_checks()
+	{
+		static int failed = 0;
+		return failed;
+	}
+}
+
+/**
+ * Check that the given condition holds, or report the failed condition and
+ * let the test fail without aborting it.
+ */
+#define TRACEUR_CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			std::fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			traceur::failed_checks()++; \
+		} \
+	} while (0)
+
+/**
+ * The exit status of the test.
+ */
+#define TRACEUR_CHECK_STATUS (traceur::failed_checks() == 0 ? 0 : 1)
+
+#endif /* TRACEUR_CORE_TESTS_CHECK_H */
@@ -0,0 +1,165 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <cstdlib>
+#include <vector>
+
+#include <check.hpp>
+#include <traceur/core/kernel/curve.hpp>
+
+namespace {
+	const traceur::SpaceFillingCurve curves[] = {
+		traceur::SpaceFillingCurve::Scanline,
+		traceur::SpaceFillingCurve::Morton,
+		traceur::SpaceFillingCurve::Hilbert
+	};
+
+	/**
+	 * The sizes of the grids that are checked, of which some are square
+	 * with a power of two side and some are not.
+	 */
+	const glm::ivec2 sizes[] = {
+		glm::ivec2(1, 1), glm::ivec2(2, 2), glm::ivec2(8, 8), glm::ivec2(32, 32),
+		glm::ivec2(5, 3), glm::ivec2(3, 17), glm::ivec2(16, 9), glm::ivec2(1, 7)
+	};
+
+	/**
+	 * Determine whether the given points visit every cell of a grid once.
+	 *
+	 * @param[in] points The points to check.
+	 * @param[in] size The size of the grid.
+	 * @return <code>true</code> if the points cover the grid, otherwise
+	 * <code>false</code>.
+	 */
+	bool covers(const std::vector<glm::ivec2> &points, const glm::ivec2 &size)
+	{
+		std::vector<int> visits(static_cast<size_t>(size.x * size.y), 0);
+		for (const auto &p : points) {
+			if (p.x < 0 || p.y < 0 || p.x >= size.x || p.y >= size.y) {
+				return false;
+			}
+			visits[p.y * size.x + p.x]++;
+		}
+		for (int v : visits) {
+			if (v != 1) {
+				return false;
+			}
+		}
+		return points.size() == visits.size();
+	}
+
+	/**
+	 * Return the position of every cell of a grid in the given order.
+	 *
+	 * @param[in] points The cells in order.
+	 * @param[in] size The size of the grid.
+	 * @return The position of every cell, indexed by row.
+	 */
+	std::vector<int> positions(const std::vector<glm::ivec2> &points, const glm::ivec2 &size)
+	{
+		std::vector<int> position(static_cast<size_t>(size.x * size.y), -1);
+		for (size_t i = 0; i < points.size(); i++) {
+			position[points[i].y * size.x + points[i].x] = static_cast<int>(i);
+		}
+		return position;
+	}
+
+	void check_coverage()
+	{
+		for (auto curve : curves) {
+			for (const auto &size : sizes) {
+				TRACEUR_CHECK(covers(traceur::curve_points(curve, size.x, size.y), size));
+			}
+			TRACEUR_CHECK(traceur::curve_points(curve, 0, 4).empty());
+			TRACEUR_CHECK(traceur::curve_points(curve, 4, -1).empty());
+		}
+	}
+
+	void check_scanline()
+	{
+		auto points = traceur::curve_points(traceur::SpaceFillingCurve::Scanline, 5, 3);
+		for (size_t i = 0; i < points.size(); i++) {
+			TRACEUR_CHECK(points[i] == glm::ivec2(static_cast<int>(i) % 5, static_cast<int>(i) / 5));
+		}
+	}
+
+	void check_morton()
+	{
+		auto points = traceur::curve_points(traceur::SpaceFillingCurve::Morton, 4, 4);
+		TRACEUR_CHECK(points[0] == glm::ivec2(0, 0));
+		TRACEUR_CHECK(points[1] == glm::ivec2(1, 0));
+		TRACEUR_CHECK(points[2] == glm::ivec2(0, 1));
+		TRACEUR_CHECK(points[3] == glm::ivec2(1, 1));
+		TRACEUR_CHECK(points[4] == glm::ivec2(2, 0));
+
+		/* A cell is visited after its left and upper neighbour, also when
+		 * cells outside the grid are skipped */
+		for (const auto &size : sizes) {
+			auto position = positions(traceur::curve_points(traceur::SpaceFillingCurve::Morton, size.x, size.y), size);
+			for (int y = 0; y < size.y; y++) {
+				for (int x = 0; x < size.x; x++) {
+					int p = position[y * size.x + x];
+					TRACEUR_CHECK(x == 0 || position[y * size.x + x - 1] < p);
+					TRACEUR_CHECK(y == 0 || position[(y - 1) * size.x + x] < p);
+				}
+			}
+		}
+	}
+
+	void check_hilbert()
+	{
+		/* Consecutive cells are adjacent on square grids with a power of
+		 * two side */
+		for (int side : { 2, 4, 8, 32 }) {
+			auto points = traceur::curve_points(traceur::SpaceFillingCurve::Hilbert, side, side);
+			TRACEUR_CHECK(points.front() == glm::ivec2(0, 0));
+			for (size_t i = 1; i < points.size(); i++) {
+				glm::ivec2 step = points[i] - points[i - 1];
+				TRACEUR_CHECK(std::abs(step.x) + std::abs(step.y) == 1);
+			}
+		}
+	}
+
+	void check_names()
+	{
+		for (auto curve : curves) {
+			traceur::SpaceFillingCurve parsed = traceur::SpaceFillingCurve::Scanline;
+			TRACEUR_CHECK(traceur::parse_curve(traceur::curve_name(curve), parsed));
+			TRACEUR_CHECK(parsed == curve);
+		}
+
+		traceur::SpaceFillingCurve parsed = traceur::SpaceFillingCurve::Morton;
+		TRACEUR_CHECK(!traceur::parse_curve("peano", parsed));
+		TRACEUR_CHECK(parsed == traceur::SpaceFillingCurve::Morton);
+	}
+}
+
+int main()
+{
+	check_coverage();
+	check_scanline();
+	check_morton();
+	check_hilbert();
+	check_names();
+	return TRACEUR_CHECK_STATUS;
+}
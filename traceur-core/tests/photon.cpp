@@ -0,0 +1,175 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <check.hpp>
+#include <traceur/core/lightning/photon.hpp>
+
+#include <glm/gtc/constants.hpp>
+
+namespace {
+	/**
+	 * Draw a float in the range [0, 1) from the given generator, which
+	 * unlike the standard distributions gives the same numbers on every
+	 * platform.
+	 *
+	 * @param[in] random The generator to draw from.
+	 * @return The drawn float.
+	 */
+	float uniform(std::mt19937 &random)
+	{
+		return (random() >> 8) * (1.f / 16777216.f);
+	}
+
+	/**
+	 * Create photons of which most lie in the unit cube, some lie on a plane
+	 * and some share their position.
+	 *
+	 * @param[in] count The amount of photons.
+	 * @return The photons.
+	 */
+	std::vector<traceur::Photon> make_photons(size_t count)
+	{
+		std::mt19937 random(47);
+		std::vector<traceur::Photon> photons(count);
+		for (size_t i = 0; i < count; i++) {
+			auto &photon = photons[i];
+			photon.position = glm::vec3(uniform(random), uniform(random), uniform(random));
+			if (i % 4 == 0) {
+				photon.position.y = 0.5f;
+			} else if (i % 7 == 0) {
+				photon.position = photons[i - 1].position;
+			}
+			photon.power = glm::vec3(1.f);
+			photon.direction = glm::vec3(0, -1, 0);
+			photon.axis = 0;
+		}
+		return photons;
+	}
+
+	/**
+	 * Compute the squared distance of a photon to a point.
+	 *
+	 * @param[in] photon The photon.
+	 * @param[in] position The position of the point.
+	 * @return The squared distance.
+	 */
+	float distance2(const traceur::Photon &photon, const glm::vec3 &position)
+	{
+		glm::vec3 delta = photon.position - position;
+		return glm::dot(delta, delta);
+	}
+
+	void check_nearest()
+	{
+		auto photons = make_photons(3000);
+		traceur::PhotonMap map(photons, 50, 0.1f);
+		TRACEUR_CHECK(map.size() == photons.size());
+
+		std::mt19937 random(1);
+		const traceur::Photon *found[traceur::PhotonMap::MaximumNeighbours];
+		for (int query = 0; query < 100; query++) {
+			glm::vec3 position(uniform(random) * 1.2f - 0.1f, uniform(random) * 1.2f - 0.1f, uniform(random) * 1.2f - 0.1f);
+			if (query % 5 == 0) {
+				position = photons[query].position;
+			}
+
+			for (int k : { 1, 8, 50, traceur::PhotonMap::MaximumNeighbours, 1000 }) {
+				for (float maxDistance : { 0.02f, 0.1f, 10.f }) {
+					/* Compare against the photons within the distance by brute force */
+					std::vector<float> expected;
+					for (const auto &photon : photons) {
+						float d2 = distance2(photon, position);
+						if (d2 < maxDistance * maxDistance) {
+							expected.push_back(d2);
+						}
+					}
+					std::sort(expected.begin(), expected.end());
+					size_t limit = static_cast<size_t>(std::min(k, traceur::PhotonMap::MaximumNeighbours));
+					expected.resize(std::min(expected.size(), limit));
+
+					float farthest = -1.f;
+					int count = map.nearest(position, k, maxDistance, found, farthest);
+					TRACEUR_CHECK(count == static_cast<int>(expected.size()));
+					if (count != static_cast<int>(expected.size())) {
+						continue;
+					}
+
+					std::vector<float> actual;
+					for (int i = 0; i < count; i++) {
+						actual.push_back(distance2(*found[i], position));
+					}
+					std::sort(actual.begin(), actual.end());
+					TRACEUR_CHECK(actual == expected);
+
+					float bound = static_cast<size_t>(count) == limit ? expected.back() : maxDistance * maxDistance;
+					TRACEUR_CHECK(farthest == bound);
+				}
+			}
+		}
+	}
+
+	void check_empty()
+	{
+		traceur::PhotonMap map(std::vector<traceur::Photon>(), 50, 0.1f);
+		TRACEUR_CHECK(map.empty());
+
+		const traceur::Photon *found[1];
+		float farthest = -1.f;
+		TRACEUR_CHECK(map.nearest(glm::vec3(0.5f), 1, 0.5f, found, farthest) == 0);
+		TRACEUR_CHECK(farthest == 0.25f);
+		TRACEUR_CHECK(map.irradiance(glm::vec3(0.5f), glm::vec3(0, 1, 0)) == glm::vec3(0));
+		TRACEUR_CHECK(traceur::PhotonMap().irradiance(glm::vec3(0.5f), glm::vec3(0, 1, 0)) == glm::vec3(0));
+	}
+
+	void check_irradiance()
+	{
+		auto photons = make_photons(3000);
+		traceur::PhotonMap map(photons, 50, 0.2f);
+
+		/* All photons travel downwards, so only upward facing surfaces
+		 * receive their power, spread over the disc of the farthest one */
+		glm::vec3 position(0.5f, 0.5f, 0.5f);
+		const traceur::Photon *found[traceur::PhotonMap::MaximumNeighbours];
+		float farthest;
+		int count = map.nearest(position, 50, 0.2f, found, farthest);
+		TRACEUR_CHECK(count == 50);
+
+		glm::vec3 expected = glm::vec3(count) / (glm::pi<float>() * farthest);
+		glm::vec3 irradiance = map.irradiance(position, glm::vec3(0, 1, 0));
+		TRACEUR_CHECK(glm::length(irradiance - expected) < 1e-3f * glm::length(expected));
+		TRACEUR_CHECK(map.irradiance(position, glm::vec3(0, -1, 0)) == glm::vec3(0));
+	}
+}
+
+int main()
+{
+	check_nearest();
+	check_empty();
+	check_irradiance();
+	return TRACEUR_CHECK_STATUS;
+}
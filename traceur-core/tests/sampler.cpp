@@ -0,0 +1,180 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <cmath>
+#include <set>
+#include <string>
+
+#include <check.hpp>
+#include <traceur/core/sampler/sampler.hpp>
+#include <traceur/core/sampler/halton.hpp>
+#include <traceur/core/sampler/sobol.hpp>
+
+namespace {
+	/**
+	 * The pixels at which the samplers are checked.
+	 */
+	const glm::ivec2 pixels[] = { glm::ivec2(0, 0), glm::ivec2(7, 3), glm::ivec2(511, 1023) };
+
+	/**
+	 * Determine whether the first points of a dimension of a sampler fall
+	 * into distinct strata of the unit interval.
+	 *
+	 * @param[in] sampler The sampler to check.
+	 * @param[in] pixel The pixel to sample.
+	 * @param[in] dimension The dimension to sample.
+	 * @param[in] count The amount of points and strata.
+	 * @return <code>true</code> if every stratum holds a single point,
+	 * otherwise <code>false</code>.
+	 */
+	bool stratified(const traceur::Sampler &sampler, const glm::ivec2 &pixel, uint32_t dimension, uint32_t count)
+	{
+		std::set<uint32_t> strata;
+		for (uint32_t i = 0; i < count; i++) {
+			strata.insert(static_cast<uint32_t>(sampler.sample(pixel, i, dimension) * count));
+		}
+		return strata.size() == count;
+	}
+
+	/**
+	 * Determine whether the first points of two dimensions of a sampler form
+	 * a (0, m, 2)-net in base two, of which every elementary interval holds
+	 * a single point.
+	 *
+	 * @param[in] sampler The sampler to check.
+	 * @param[in] pixel The pixel to sample.
+	 * @param[in] m The logarithm of the amount of points.
+	 * @return <code>true</code> if the points form a net, otherwise
+	 * <code>false</code>.
+	 */
+	bool net(const traceur::Sampler &sampler, const glm::ivec2 &pixel, uint32_t m)
+	{
+		for (uint32_t a = 0; a <= m; a++) {
+			std::set<std::pair<uint32_t, uint32_t>> intervals;
+			for (uint32_t i = 0; i < (1u << m); i++) {
+				float x = sampler.sample(pixel, i, 0);
+				float y = sampler.sample(pixel, i, 1);
+				intervals.insert(std::make_pair(static_cast<uint32_t>(x * (1u << a)),
+												static_cast<uint32_t>(y * (1u << (m - a)))));
+			}
+			if (intervals.size() != (1u << m)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	void check_bits()
+	{
+		TRACEUR_CHECK(traceur::reverse_bits(1u) == 0x80000000u);
+		TRACEUR_CHECK(traceur::reverse_bits(0x0000fff0u) == 0x0fff0000u);
+		TRACEUR_CHECK(traceur::reverse_bits(traceur::reverse_bits(0x12345678u)) == 0x12345678u);
+
+		/* The scramble maps an aligned block onto an aligned block */
+		for (uint32_t seed : { 1u, 0x9e3779b9u, 0xdeadbeefu }) {
+			std::set<uint32_t> values, blocks;
+			for (uint32_t i = 256; i < 512; i++) {
+				uint32_t x = traceur::owen_scramble(i, seed);
+				values.insert(x);
+				blocks.insert(x >> 8);
+			}
+			TRACEUR_CHECK(values.size() == 256);
+			TRACEUR_CHECK(blocks.size() == 1);
+		}
+	}
+
+	void check_sobol()
+	{
+		for (bool scrambled : { false, true }) {
+			traceur::SobolSampler sampler(scrambled);
+			for (const auto &pixel : pixels) {
+				/* Include the dimensions padded by a shuffled copy */
+				for (uint32_t d = 0; d < 2 * sampler.blockSize(); d++) {
+					TRACEUR_CHECK(stratified(sampler, pixel, d, 64));
+				}
+				TRACEUR_CHECK(net(sampler, pixel, 6));
+			}
+		}
+
+		/* The first points of the unscrambled sequence are the well-known
+		 * van der Corput points up to a per-pixel digital shift */
+		traceur::SobolSampler sampler(false);
+		float first = sampler.sample(pixels[0], 0, 0);
+		float second = sampler.sample(pixels[0], 1, 0);
+		TRACEUR_CHECK(std::fabs(std::fabs(first - second) - 0.5f) < 1e-6f);
+	}
+
+	void check_halton()
+	{
+		traceur::HaltonSampler sampler;
+		const uint32_t primes[] = { 2, 3, 5, 7 };
+		for (const auto &pixel : pixels) {
+			for (uint32_t d = 0; d < 4; d++) {
+				TRACEUR_CHECK(stratified(sampler, pixel, d, primes[d] * primes[d]));
+			}
+
+			/* The first wrap reuses base two, of which the shuffled points
+			 * are still stratified */
+			TRACEUR_CHECK(stratified(sampler, pixel, 32, 64));
+
+			/* A wrapped dimension is not a rotation of its base */
+			for (uint32_t d : { 0u, 5u }) {
+				std::set<long> shifts;
+				for (uint32_t i = 0; i < 64; i++) {
+					double shift = sampler.sample(pixel, i, d + 32) - sampler.sample(pixel, i, d);
+					shifts.insert(std::lround((shift < 0 ? shift + 1 : shift) * 1e4));
+				}
+				TRACEUR_CHECK(shifts.size() > 1);
+			}
+		}
+	}
+
+	void check_range()
+	{
+		for (const std::string name : { "independent", "halton", "sobol", "owen", "bluenoise" }) {
+			auto sampler = traceur::make_sampler(name);
+			TRACEUR_CHECK(sampler != nullptr);
+			if (!sampler) {
+				continue;
+			}
+			TRACEUR_CHECK(sampler->name() == name);
+			for (uint32_t i = 0; i < 256; i++) {
+				for (uint32_t d = 0; d < 40; d++) {
+					float value = sampler->sample(pixels[1], i, d);
+					TRACEUR_CHECK(value >= 0.f && value < 1.f);
+					TRACEUR_CHECK(value == sampler->sample(pixels[1], i, d));
+				}
+			}
+		}
+		TRACEUR_CHECK(traceur::make_sampler("unknown") == nullptr);
+	}
+}
+
+int main()
+{
+	check_bits();
+	check_sobol();
+	check_halton();
+	check_range();
+	return TRACEUR_CHECK_STATUS;
+}
@@ -0,0 +1,123 @@
+/*
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2017 Traceur authors
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+#include <cmath>
+#include <limits>
+
+#include <check.hpp>
+#include <traceur/core/math/simd.hpp>
+
+namespace {
+	const float nan = std::numeric_limits<float>::quiet_NaN();
+	const float inf = std::numeric_limits<float>::infinity();
+
+	/**
+	 * The values from which the lanes of the checked vectors are drawn.
+	 */
+	const float values[] = { nan, -inf, -2.5f, 1.f, 3.f, inf };
+	const int count = sizeof(values) / sizeof(values[0]);
+
+	/**
+	 * Determine whether two floats are equal or both not a number.
+	 *
+	 * @param[in] a The first float.
+	 * @param[in] b The second float.
+	 * @return <code>true</code> if the floats are the same, otherwise
+	 * <code>false</code>.
+	 */
+	bool same(float a, float b)
+	{
+		return a == b || (std::isnan(a) && std::isnan(b));
+	}
+
+	void check_lanes()
+	{
+		for (int i = 0; i < count; i++) {
+			for (int j = 0; j < count; j++) {
+				/* Place the pair in a different lane for every combination */
+				int lane = (i + j) % 4;
+				float a[4] = { 0.f, 0.f, 0.f, 0.f };
+				float b[4] = { 0.f, 0.f, 0.f, 0.f };
+				a[lane] = values[i];
+				b[lane] = values[j];
+				traceur::Float4 x(a[0], a[1], a[2], a[3]);
+				traceur::Float4 y(b[0], b[1], b[2], b[3]);
+
+				TRACEUR_CHECK(same(traceur::fmin(x, y)[lane], std::fmin(values[i], values[j])));
+				TRACEUR_CHECK(same(traceur::fmax(x, y)[lane], std::fmax(values[i], values[j])));
+				TRACEUR_CHECK(((traceur::greaterEqual(x, y) >> lane) & 1) == (values[i] >= values[j]));
+				TRACEUR_CHECK(((traceur::lessEqual(x, y) >> lane) & 1) == (values[i] <= values[j]));
+			}
+		}
+	}
+
+	void check_reductions()
+	{
+		/* Every combination of lanes, including all lanes not a number */
+		for (int i = 0; i < count * count * count * count; i++) {
+			float v[4] = { values[i % count], values[i / count % count],
+						   values[i / count / count % count], values[i / count / count / count] };
+			traceur::Float4 x(v[0], v[1], v[2], v[3]);
+
+			float minimum = std::fmin(std::fmin(v[0], v[1]), std::fmin(v[2], v[3]));
+			float maximum = std::fmax(std::fmax(v[0], v[1]), std::fmax(v[2], v[3]));
+			TRACEUR_CHECK(same(x.minimum(), minimum));
+			TRACEUR_CHECK(same(x.maximum(), maximum));
+		}
+	}
+
+	void check_box()
+	{
+		/* Include origins on the faces of the box and directions parallel
+		 * to them, for which the slabs compute zero times infinity */
+		const traceur::AABB box(glm::vec3(0.f), glm::vec3(1.f));
+		const float origins[] = { -1.f, 0.f, 0.5f, 1.f, 2.f };
+		const float directions[] = { -1.f, -0.f, 0.f, 0.5f };
+
+		for (int o = 0; o < 5 * 5 * 5; o++) {
+			glm::vec3 origin(origins[o % 5], origins[o / 5 % 5], origins[o / 25]);
+			for (int d = 0; d < 4 * 4 * 4; d++) {
+				glm::vec3 direction(directions[d % 4], directions[d / 4 % 4], directions[d / 16]);
+				if (direction == glm::vec3(0.f)) {
+					continue;
+				}
+
+				traceur::Ray ray(origin, direction);
+				float tmin, tmax, smin, smax;
+				bool expected = box.intersect(ray, tmin, tmax);
+				bool actual = traceur::AlignedBox(box).intersect(traceur::AlignedRay(ray), smin, smax);
+				TRACEUR_CHECK(actual == expected);
+				TRACEUR_CHECK(same(smin, tmin));
+				TRACEUR_CHECK(same(smax, tmax));
+			}
+		}
+	}
+}
+
+int main()
+{
+	check_lanes();
+	check_reductions();
+	check_box();
+	return TRACEUR_CHECK_STATUS;
+}
@@ -23,6 +23,7 @@
  */
 #include <ctime>
 #include <chrono>
+#include <limits>
 #include <memory>
 #include <iostream>
 #include <thread>
@@ -33,13 +34,143 @@
 #include <glm/glm.hpp>
 
 #include <traceur/core/kernel/basic.hpp>
+#include <traceur/core/kernel/channel.hpp>
+#include <traceur/core/kernel/curve.hpp>
+#include <traceur/core/kernel/denoise.hpp>
 #include <traceur/core/kernel/multithreaded.hpp>
+#include <traceur/core/kernel/pathtracing.hpp>
+#include <traceur/core/kernel/photonmap.hpp>
+#include <traceur/core/kernel/progressive.hpp>
+#include <traceur/core/math/isa.hpp>
+#include <traceur/core/sampler/sampler.hpp>
 #include <traceur/core/scene/graph/factory.hpp>
 #include <traceur/core/scene/graph/vector.hpp>
 #include <traceur/core/scene/graph/kdtree.hpp>
 #include <traceur/loader/wavefront.hpp>
 #include <traceur/exporter/ppm.hpp>
 
+/**
+ * A {@link KernelObserver} that exports the result of every pass of a
+ * progressive render job, so the best image so far is always available.
+ */
+class PassExporter : public traceur::KernelObserver {
+public:
+	/**
+	 * The path to export the results to.
+	 */
+	std::string target;
+
+	/**
+	 * Construct a {@link PassExporter} instance.
+	 *
+	 * @param[in] exporter The exporter to use.
+	 */
+	PassExporter(std::shared_ptr<traceur::Exporter> exporter) : exporter(exporter) {}
+
+	/**
+	 * This method is invoked when a pass of a progressive render job is
+	 * finished on the kernel.
+	 *
+	 * @param[in] kernel The kernel that is rendering the scene.
+	 * @param[in] pass The index of the pass that has finished.
+	 * @param[in] film The {@link Film} containing the result of all passes so
+	 * far.
+	 */
+	virtual void passFinished(const traceur::Kernel &,
+							  int pass,
+							  const traceur::Film &film) override final
+	{
+		exporter->write(film, target);
+		printf("[pass %d] Saved result to %s\n", pass + 1, target.c_str());
+	}
+private:
+	/**
+	 * The exporter to use.
+	 */
+	std::shared_ptr<traceur::Exporter> exporter;
+};
+
+/**
+ * Render a channel of a film as image, so it can be exported.
+ *
+ * Depths and sample counts are scaled by their maximum, normals are mapped
+ * from [-1, 1] to [0, 1] and identifiers are hashed to random colors.
+ *
+ * @param[in] film The film to render the channel of.
+ * @param[in] channel The channel to render.
+ * @return The image of the channel.
+ */
+std::unique_ptr<traceur::DirectFilm> visualize(const traceur::Film &film, traceur::Channels::Channel channel)
+{
+	auto image = std::make_unique<traceur::DirectFilm>(film.width, film.height);
+	auto hash = [](uint32_t id) {
+		if (id == std::numeric_limits<uint32_t>::max()) {
+			return traceur::Pixel(0, 0, 0);
+		}
+		id = (id ^ 61u) ^ (id >> 16);
+		id *= 9u;
+		id ^= id >> 4;
+		id *= 0x27d4eb2du;
+		id ^= id >> 15;
+		return traceur::Pixel(id & 0xff, (id >> 8) & 0xff, (id >> 16) & 0xff) / 255.f;
+	};
+
+	auto pixels = image->data();
+	size_t size = static_cast<size_t>(film.width) * static_cast<size_t>(film.height);
+
+	// convert the values of the channel to colors, of which the plane is
+	// read from the film once
+	auto convert = [&](auto tag, auto color) {
+		std::vector<typename traceur::ChannelTraits<decltype(tag)::value>::type> storage;
+		auto values = film.template plane<decltype(tag)::value>(storage);
+		for (size_t i = 0; i < size; i++) {
+			pixels[i] = color(values[i]);
+		}
+	};
+
+	// the depths and the sample counts are scaled by their maximum
+	auto scaled = [&](auto tag) {
+		std::vector<typename traceur::ChannelTraits<decltype(tag)::value>::type> storage;
+		auto values = film.template plane<decltype(tag)::value>(storage);
+		float maximum = 0;
+		for (size_t i = 0; i < size; i++) {
+			maximum = std::max(maximum, static_cast<float>(values[i]));
+		}
+		float scale = maximum > 0 ? 1.f / maximum : 0.f;
+		for (size_t i = 0; i < size; i++) {
+			pixels[i] = traceur::Pixel(static_cast<float>(values[i]) * scale);
+		}
+	};
+
+	switch (channel) {
+		case traceur::Channels::Depth:
+			scaled(traceur::ChannelTag<traceur::Channels::Depth>());
+			break;
+		case traceur::Channels::Normal:
+			convert(traceur::ChannelTag<traceur::Channels::Normal>(), [](const traceur::HalfNormal &normal) {
+				return traceur::Pixel(glm::vec3(normal) * 0.5f + 0.5f);
+			});
+			break;
+		case traceur::Channels::Albedo:
+			convert(traceur::ChannelTag<traceur::Channels::Albedo>(), [](const glm::vec3 &albedo) {
+				return traceur::Pixel(albedo);
+			});
+			break;
+		case traceur::Channels::PrimitiveId:
+			convert(traceur::ChannelTag<traceur::Channels::PrimitiveId>(), hash);
+			break;
+		case traceur::Channels::MaterialId:
+			convert(traceur::ChannelTag<traceur::Channels::MaterialId>(), hash);
+			break;
+		case traceur::Channels::SampleCount:
+			scaled(traceur::ChannelTag<traceur::Channels::SampleCount>());
+			break;
+		default:
+			break;
+	}
+	return image;
+}
+
 /**
  * The main entry point of the program.
  *
@@ -53,6 +184,19 @@ int main(int argc, char** argv)
 	int height = 800;
 	int workers = std::thread::hardware_concurrency();
 	int partitions = 64;
+	int lightSamples = 50;
+	std::string samplerName = "owen";
+	auto intersector = traceur::TriangleIntersector::Geometric;
+	auto isa = traceur::detect_isa();
+	auto order = traceur::SpaceFillingCurve::Scanline;
+	int cacheResolution = 0;
+	int photons = 0;
+	int pathDepth = 0;
+	bool denoise = false;
+	unsigned channels = 0;
+	traceur::AntiAliasing antiAliasing;
+	int passes = 0;
+	double budget = 0;
 	std::pair<int, int> range = std::pair<int, int>(0, partitions);
 
 
@@ -63,7 +207,7 @@ int main(int argc, char** argv)
 
 	float x = 0.f, y = 0.f, z = 0.f;
 	int a = 0, b = 0;
-	while ((c = getopt(argc, argv, "w:h:e:c:u:N:p:r:")) != -1) {
+	while ((c = getopt(argc, argv, "w:h:e:c:u:N:p:r:l:s:a:P:T:i:I:o:v:m:g:dC:")) != -1) {
 		switch(c) {
 			case 'w':
 				width = atoi(optarg);
@@ -92,21 +236,117 @@ int main(int argc, char** argv)
 				sscanf(optarg, "(%f, %f, %f)", &x, &y, &z);
 				up = glm::vec3(x, y, z);
 				break;
+			case 'l':
+				lightSamples = atoi(optarg);
+				if (lightSamples < 1) {
+					fprintf(stderr, "error: the amount of light samples must be at least 1\n");
+					return 1;
+				}
+				break;
+			case 's':
+				samplerName = optarg;
+				break;
+			case 'a':
+				if (sscanf(optarg, "(%d, %d, %f)", &a, &b, &x) != 3) {
+					fprintf(stderr, "error: the anti-aliasing must be given as (min, max, threshold)\n");
+					return 1;
+				}
+				if (a < 1 || a > b) {
+					fprintf(stderr, "error: the anti-aliasing samples must satisfy 0 < min <= max\n");
+					return 1;
+				}
+				if (b > std::numeric_limits<uint16_t>::max()) {
+					fprintf(stderr, "error: at most %d samples per pixel are supported\n",
+							std::numeric_limits<uint16_t>::max());
+					return 1;
+				}
+				if (!(x >= 0)) {
+					fprintf(stderr, "error: the anti-aliasing threshold must not be negative\n");
+					return 1;
+				}
+				antiAliasing = traceur::AntiAliasing(a, b, x);
+				break;
+			case 'P':
+				passes = atoi(optarg);
+				break;
+			case 'T':
+				budget = atof(optarg);
+				break;
+			case 'i':
+				if (std::string(optarg) == "transform") {
+					intersector = traceur::TriangleIntersector::Transform;
+				} else if (std::string(optarg) != "geometric") {
+					fprintf(stderr, "error: unknown triangle intersector \"%s\"\n", optarg);
+					return 1;
+				}
+				break;
+			case 'I':
+				if (!traceur::parse_isa(optarg, isa)) {
+					fprintf(stderr, "error: unknown instruction set \"%s\"\n", optarg);
+					return 1;
+				} else if (!traceur::force_isa(isa)) {
+					fprintf(stderr, "error: instruction set \"%s\" is not supported by this processor\n", optarg);
+					return 1;
+				}
+				break;
+			case 'o':
+				if (!traceur::parse_curve(optarg, order)) {
+					fprintf(stderr, "error: unknown pixel order \"%s\"\n", optarg);
+					return 1;
+				}
+				break;
+			case 'v':
+				cacheResolution = atoi(optarg);
+				break;
+			case 'm':
+				photons = atoi(optarg);
+				break;
+			case 'g':
+				pathDepth = atoi(optarg);
+				break;
+			case 'd':
+				denoise = true;
+				break;
+			case 'C':
+				if (!traceur::parse_channels(optarg, channels)) {
+					fprintf(stderr, "error: unknown channels \"%s\"\n", optarg);
+					return 1;
+				}
+				break;
 			default:
 				continue;
 		}
 	}
 
+	// The path tracer and the photon map are separate kernels
+	if (pathDepth > 0 && photons > 0) {
+		fprintf(stderr, "error: the path tracer (-g) cannot be combined with the photon map (-m)\n");
+		return 1;
+	}
+
+	// The sample counts are exported as heat map of the anti-aliasing
+	if (antiAliasing.enabled()) {
+		channels |= traceur::Channels::SampleCount;
+	}
+
 	/* Scene loaders and exporters */
-	auto factory = traceur::make_factory<traceur::KDTreeSceneGraphBuilder>();
+	auto factory = traceur::make_factory<traceur::KDTreeSceneGraphBuilder>(intersector);
 	auto loader = std::make_unique<traceur::WavefrontLoader>(std::move(factory));
-	auto exporter = std::make_unique<traceur::PPMExporter>();
+	auto exporter = std::make_shared<traceur::PPMExporter>();
+	auto progress = std::make_shared<PassExporter>(exporter);
 
-	/* Tracing and scheduling kernels */
-	auto tracer = std::make_unique<traceur::BasicKernel>();
-	auto scheduler = std::make_unique<traceur::MultithreadedKernel>(
-		std::move(tracer), workers, partitions, range
-	);
+	/* The denoiser and its thread pool are only created when requested */
+	std::shared_ptr<traceur::DenoisingObserver> denoiser;
+	if (denoise) {
+		denoiser = std::make_shared<traceur::DenoisingObserver>(std::make_shared<traceur::Denoiser>(workers));
+	}
+
+	/* Sample generator */
+	auto sampler = traceur::make_sampler(samplerName);
+	if (!sampler) {
+		fprintf(stderr, "error: unknown sampler \"%s\"\n", samplerName.c_str());
+		return 1;
+	}
 
 	// Set up viewport
 	glm::ivec4 viewport = glm::ivec4(0, 0, width, height);
@@ -122,14 +362,57 @@ int main(int argc, char** argv)
 		printf("[%d] Loading scene at path \"%s\"\n", j, argv[i]);
 		auto scene = loader->load(path.str());
 
-		printf("[%d] Rendering scene [%s]\n", j, scheduler->name().c_str());
+		/* Tracing and scheduling kernels specialized for the scene */
+		auto features = traceur::kernel_features(*scene);
+		std::unique_ptr<traceur::BasicKernel> tracer;
+		if (pathDepth > 0) {
+			tracer = std::make_unique<traceur::PathTracingKernel>(sampler, pathDepth);
+		} else if (photons > 0) {
+			tracer = std::make_unique<traceur::PhotonMapKernel>(sampler, lightSamples, photons, workers, features);
+		} else {
+			tracer = std::make_unique<traceur::BasicKernel>(sampler, lightSamples, features);
+		}
+		tracer->antiAliasing = antiAliasing;
+		tracer->pixelOrder = order;
+		tracer->channels = channels;
+		if (denoise) {
+			tracer->channels |= traceur::Channels::Auxiliary;
+		}
+		if (cacheResolution > 0) {
+			tracer->visibilityCache = std::make_shared<traceur::VisibilityCache>(cacheResolution);
+		}
+		auto multithreaded = std::make_unique<traceur::MultithreadedKernel>(
+			std::move(tracer), workers, partitions, range
+		);
+		multithreaded->partitionOrder = order;
+		std::unique_ptr<traceur::Kernel> scheduler = std::move(multithreaded);
+
+		/* Render progressively if a pass count or time budget is given */
+		if (passes > 0 || budget > 0) {
+			scheduler = std::make_unique<traceur::ProgressiveKernel>(std::move(scheduler), passes, budget);
+			scheduler->add_observer(progress);
+		}
+		if (denoiser) {
+			scheduler->add_observer(denoiser);
+		}
+
+		printf("[%d] Scene features: max illumination model %d, %s%s%s\n", j,
+			   scene->features.maxIlluminationModel,
+			   features & traceur::SceneFeatures::Reflection ? "reflection " : "",
+			   features & traceur::SceneFeatures::Transmission ? "transmission " : "",
+			   features & traceur::SceneFeatures::LightSampling ? "light-sampling " : "");
+		printf("[%d] Rendering scene [%s] using %s kernels\n", j, scheduler->name().c_str(),
+			   traceur::isa_name(traceur::active_isa()));
+		progress->target = path.filename() + ".ppm";
 
 		// Time the ray tracing
 		auto beginA = std::chrono::high_resolution_clock::now();
 		auto beginB = std::clock();
 
 		// Render the scene and capture the result
+		auto statistics = scheduler->statistics();
 		auto result = scheduler->render(*scene, camera);
+		statistics = scheduler->statistics() - statistics;
 
 		// Calculate the elapsed time
 		auto endA = std::chrono::high_resolution_clock::now();
@@ -137,11 +420,42 @@ int main(int argc, char** argv)
 		double real = std::chrono::duration_cast<std::chrono::duration<double>>(endA - beginA).count();
 		double cpu = double(endB - beginB) / CLOCKS_PER_SEC;
 		printf("[%d] Rendering done (cpu %.3fs, real %.3fs)\n", j, cpu, real);
+		printf("[%d] Shadow rays: %llu, occluder cache hits: %llu (%.1f%%)\n", j,
+			   (unsigned long long) statistics.shadowRays,
+			   (unsigned long long) statistics.occluderCacheHits,
+			   statistics.occluderCacheHitRate() * 100);
+		if (cacheResolution > 0) {
+			printf("[%d] Visibility queries: %llu, visibility cache hits: %llu (%.1f%%)\n", j,
+				   (unsigned long long) statistics.visibilityQueries,
+				   (unsigned long long) statistics.visibilityCacheHits,
+				   statistics.visibilityCacheHitRate() * 100);
+		}
+		printf("[%d] Samples per pixel: %.2f, refined pixels: %llu\n", j,
+			   statistics.samplesPerPixel(),
+			   (unsigned long long) statistics.refinedPixels);
 
 		// Export the result to a file
 		auto target = path.filename() + ".ppm";
 		exporter->write(*result, target);
 		printf("[%d] Saved result to %s\n", j, target.c_str());
+
+		// Export the denoised result
+		if (denoiser && denoiser->result()) {
+			target = path.filename() + ".denoised.ppm";
+			exporter->write(*denoiser->result(), target);
+			printf("[%d] Saved denoised result to %s\n", j, target.c_str());
+		}
+
+		// Export the channels of the film, such as the amount of samples per
+		// pixel as heat map
+		for (unsigned channel = 1; channel & traceur::Channels::All; channel <<= 1) {
+			if (result->channels() & channels & channel) {
+				auto name = static_cast<traceur::Channels::Channel>(channel);
+				target = path.filename() + "." + traceur::channel_name(name) + ".ppm";
+				exporter->write(*visualize(*result, name), target);
+				printf("[%d] Saved %s channel to %s\n", j, traceur::channel_name(name), target.c_str());
+			}
+		}
 	}
 	return 0;
 }
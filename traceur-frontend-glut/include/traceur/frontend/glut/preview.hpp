@@ -28,6 +28,7 @@
 #include <condition_variable>
 #include <map>
 #include <mutex>
+#include <vector>
 
 #ifdef __APPLE__
 #include <GLUT/glut.h>
@@ -37,6 +38,7 @@
 
 #include <glm/glm.hpp>
 #include <traceur/core/kernel/observer.hpp>
+#include <traceur/core/kernel/pixel.hpp>
 
 namespace traceur {
 	/**
@@ -127,6 +129,19 @@ namespace traceur {
 									   const traceur::Film &,
 									   const glm::ivec2 &) override final;
 
+		/**
+		 * This method is invoked when a pass of a progressive render job is
+		 * finished on the kernel.
+		 *
+		 * @param[in] kernel The kernel that is rendering the scene.
+		 * @param[in] pass The index of the pass that has finished.
+		 * @param[in] film The {@link Film} containing the result of all
+		 * passes so far.
+		 */
+		virtual void passFinished(const traceur::Kernel &,
+								  int,
+								  const traceur::Film &) override final;
+
 		/**
 		 * This method is invoked when a render job is finished on the kernel.
 		 *
@@ -137,6 +152,27 @@ namespace traceur {
 									const traceur::Film &) override final;
 
 	private:
+		/**
+		 * A copy of the result of the passes of a progressive render job so
+		 * far, which is empty if no pass has finished yet.
+		 */
+		std::vector<traceur::Pixel> accumulation;
+
+		/**
+		 * The size of the accumulated result.
+		 */
+		glm::ivec2 accumulationSize;
+
+		/**
+		 * A flag to indicate the accumulated result must be uploaded.
+		 */
+		bool accumulationChanged = false;
+
+		/**
+		 * The texture identifier of the accumulated result.
+		 */
+		GLuint accumulationTexture = 0;
+
 		/**
 		 * A map that maps the partition identifier to a partition structure.
 		 */
@@ -29,6 +29,7 @@
 #include <cstdio>
 
 #include <traceur/core/kernel/observer.hpp>
+#include <traceur/core/kernel/statistics.hpp>
 
 namespace traceur {
 	/**
@@ -172,6 +173,11 @@ namespace traceur {
 		 */
 		traceur::TimePoint start;
 
+		/**
+		 * The statistics of the kernel at the start of the render job.
+		 */
+		traceur::KernelStatistics statistics;
+
 		/**
 		 * The starting {@link TimePoint}s of the partitions.
 		 */
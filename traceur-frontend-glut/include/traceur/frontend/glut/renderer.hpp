@@ -90,11 +90,11 @@ namespace traceur {
 		virtual void visit(const traceur::Box &) final;
 
 		/**
-		 * Visit a bounding {@link Box} primitive in the scene graph.
+		 * Draw a bounding box of a node in the scene graph.
 		 *
-		 * @param[in] node The node to visit.
+		 * @param[in] box The bounding box to draw.
 		 */
-		virtual void visit_bounding_box(const traceur::Box &) final;
+		virtual void visit_bounding_box(const traceur::AABB &) final;
 	};
 }
 
@@ -50,14 +50,15 @@ void traceur::DebugTracer::refraction(const traceur::Ray &ray, const traceur::Hi
 {
 	float eta;
 	glm::vec3 normal;
+	auto &material = scene->materials[hit.primitive->material];
 
 	if(glm::dot(hit.normal, ray.direction) < 0.f) {
 		// enter material
-		eta = 1.f / hit.primitive->material->opticalDensity;
+		eta = 1.f / material.opticalDensity;
 		normal = hit.normal;
 	} else {
 		// exit material
-		eta = hit.primitive->material->opticalDensity / 1.f;
+		eta = material.opticalDensity / 1.f;
 		normal = -hit.normal;
 	}
 
@@ -105,7 +106,7 @@ void traceur::DebugTracer::render() const
 	glBegin(GL_LINES);
 	for (auto &ray : rays) {
 		if (ray.primitive) {
-			glColor3fv(glm::value_ptr(ray.primitive->material->diffuse));
+			glColor3fv(glm::value_ptr(scene->materials[ray.primitive->material].diffuse));
 		} else {
 			glColor3f(0, 1, ray.depth / 25);
 		}
@@ -20,6 +20,7 @@
 
 #include <traceur/core/kernel/basic.hpp>
 #include <traceur/core/kernel/multithreaded.hpp>
+#include <traceur/core/kernel/progressive.hpp>
 #include <traceur/core/scene/graph/factory.hpp>
 #include <traceur/core/scene/graph/vector.hpp>
 #include <traceur/core/scene/graph/kdtree.hpp>
@@ -33,7 +34,7 @@
 #include <traceur/frontend/glut/trackball.hpp>
 
 // The rendering kernel to use
-std::unique_ptr<traceur::MultithreadedKernel> kernel;
+std::unique_ptr<traceur::ProgressiveKernel> kernel;
 // The scene we want to render
 std::shared_ptr<traceur::Scene> scene;
 // The scene graph visitor to draw the scene.
@@ -59,6 +60,8 @@ const unsigned int WindowSize_Y = 800;  // resolution Y
 // Projection settings
 const float zNear = 0.01f;
 const float zFar = 30.f;
+// Progressive rendering settings
+const int Passes = 16;
 
 /**
  * Initialises the front-end.
@@ -68,7 +71,9 @@ const float zFar = 30.f;
  */
 void init(const glm::ivec4 &viewport, const std::string &path)
 {
-	auto factory = traceur::make_factory<traceur::KDTreeSceneGraphBuilder>();
+	/* The scene is traced many times, so precompute the triangle transforms */
+	auto intersector = traceur::TriangleIntersector::Transform;
+	auto factory = traceur::make_factory<traceur::KDTreeSceneGraphBuilder>(intersector);
 	auto loader = std::make_unique<traceur::WavefrontLoader>(std::move(factory));
 	printf("[main] Loading model at path \"%s\"\n", path.c_str());
 	scene = loader->load(path);
@@ -77,11 +82,17 @@ void init(const glm::ivec4 &viewport, const std::string &path)
 	int threads = std::thread::hardware_concurrency();
 	int partitions = 64 * threads;
 
-	kernel = std::make_unique<traceur::MultithreadedKernel>(
-		std::make_shared<traceur::BasicKernel>(),
+	/* The scene and its lights are static between renders, so the visibility
+	 * of the lights is cached until a light is moved */
+	auto tracer = std::make_shared<traceur::BasicKernel>();
+	tracer->visibilityCache = std::make_shared<traceur::VisibilityCache>();
+
+	auto scheduler = std::make_shared<traceur::MultithreadedKernel>(
+		tracer,
 		threads,
 		partitions
 	);
+	kernel = std::make_unique<traceur::ProgressiveKernel>(scheduler, Passes, 0);
 
 	// Set up the initial camera
 	traceur::Camera camera = traceur::Camera(viewport)
@@ -94,7 +105,8 @@ void init(const glm::ivec4 &viewport, const std::string &path)
 	debug = std::make_unique<traceur::DebugTracer>(scene, 10);
 	exporter = std::make_unique<traceur::PPMExporter>();
 
-	kernel->add_observer(std::make_shared<traceur::ConsoleProgressObserver>(30));
+	scheduler->add_observer(std::make_shared<traceur::ConsoleProgressObserver>(30));
+	scheduler->add_observer(preview);
 	kernel->add_observer(preview);
 
 	scene->lights.push_back(camera.position());
@@ -25,6 +25,7 @@
 #include <glm/gtc/type_ptr.hpp>
 
 #include <traceur/core/kernel/kernel.hpp>
+#include <traceur/core/kernel/progressive.hpp>
 #include <traceur/frontend/glut/preview.hpp>
 
 void traceur::GLUTPreviewObserver::render()
@@ -58,12 +59,52 @@ void traceur::GLUTPreviewObserver::render()
 
 	/* Draw render progress */
 	std::unique_lock<std::mutex> lock(mutex);
+
+	// Draw the result of the finished passes of a progressive render job
+	bool progressive = !accumulation.empty();
+	if (progressive) {
+		if (accumulationTexture == 0) {
+			glGenTextures(1, &accumulationTexture);
+			glBindTexture(GL_TEXTURE_2D, accumulationTexture);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		}
+		glEnable(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, accumulationTexture);
+		if (accumulationChanged) {
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, accumulationSize.x, accumulationSize.y, 0, GL_RGB, GL_FLOAT, glm::value_ptr(accumulation[0]));
+			accumulationChanged = false;
+		}
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_DECAL);
+
+		glBegin(GL_QUADS);
+		glTexCoord2i(1, 1);
+		glVertex3f(accumulationSize.x, accumulationSize.y, 0);
+		glTexCoord2i(0, 1);
+		glVertex3f(0, accumulationSize.y, 0);
+		glTexCoord2i(0, 0);
+		glVertex3f(0, 0, 0);
+		glTexCoord2i(1, 0);
+		glVertex3f(accumulationSize.x, 0, 0);
+		glEnd();
+
+		glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glDisable(GL_TEXTURE_2D);
+	}
+
 	for (auto &part : partitions) {
 		auto id = part.first;
 		auto &partition = part.second;
 		auto size = partition.size;
 		auto offset = partition.offset;
 
+		// The finished partitions of a single pass are noisier than the
+		// accumulated result, so only draw the progress of the pass.
+		if (progressive && partition.finished) {
+			continue;
+		}
+
 		if (partition.finished) {
 			// If there does not exist a texture for this partition, create a new one with the data in the film buffer.
 			if (partition.texture == 0) {
@@ -117,6 +158,12 @@ void traceur::GLUTPreviewObserver::renderStarted(const traceur::Kernel &kernel,
 												 const traceur::Camera &,
 												 int partitions)
 {
+	// A progressive render job starts with an empty result
+	if (dynamic_cast<const traceur::ProgressiveKernel *>(&kernel)) {
+		std::unique_lock<std::mutex> lock(mutex);
+		accumulation.clear();
+	}
+
 	reset.store(true);
 	std::unique_lock<std::mutex> lock(mutex);
 	condition.wait(lock);
@@ -146,5 +193,20 @@ void traceur::GLUTPreviewObserver::partitionFinished(const traceur::Kernel &kern
 	partitions[id].finished = true;
 }
 
+void traceur::GLUTPreviewObserver::passFinished(const traceur::Kernel &,
+												int,
+												const traceur::Film &film)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	accumulationSize = glm::ivec2(film.width, film.height);
+	accumulation.resize(static_cast<size_t>(film.width * film.height));
+	for (int y = 0; y < film.height; y++) {
+		for (int x = 0; x < film.width; x++) {
+			accumulation[y * film.width + x] = film(x, y);
+		}
+	}
+	accumulationChanged = true;
+}
+
 void traceur::GLUTPreviewObserver::renderFinished(const traceur::Kernel &kernel,
 												  const traceur::Film &) {}
@@ -48,6 +48,7 @@ void traceur::ConsoleProgressObserver::renderStarted(const traceur::Kernel &kern
 
 	// Initialise timer
 	start = traceur::TimePoint();
+	statistics = kernel.statistics();
 
 	// Initialise progress counters
 	progress.total = partitions;
@@ -114,4 +115,14 @@ void traceur::ConsoleProgressObserver::renderFinished(const traceur::Kernel &ker
 		"[%s] cpu [%.3fs total, %.3fs mean], real [%.3fs total, %.3fs mean]\n",
 		kernel.name().c_str(), elapsed.cpu, cpu_mean, elapsed.wall, wall_mean
 	);
+
+	// Report the statistics of this render job
+	auto collected = kernel.statistics() - statistics;
+	printf(
+		"[%s] shadow rays [%llu total, %llu occluder cache hits (%.1f%%)]\n",
+		kernel.name().c_str(),
+		(unsigned long long) collected.shadowRays,
+		(unsigned long long) collected.occluderCacheHits,
+		collected.occluderCacheHitRate() * 100
+	);
 }
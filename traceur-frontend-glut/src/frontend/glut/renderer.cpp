@@ -50,7 +50,7 @@ void traceur::GLUTSceneRenderer::visit(const traceur::Sphere &sphere)
 	auto o = sphere.origin;
 	glPushMatrix();
 	glTranslatef(o[0], o[1], o[2]);
-	glColor3fv(glm::value_ptr(sphere.material->diffuse));
+	glColor3fv(glm::value_ptr(scene->materials[sphere.material].diffuse));
 	glutSolidSphere(sphere.radius, 50, 50);
 	glPopMatrix();
 }
@@ -58,7 +58,7 @@ void traceur::GLUTSceneRenderer::visit(const traceur::Sphere &sphere)
 void traceur::GLUTSceneRenderer::visit(const traceur::Triangle &triangle)
 {
 	glBegin(GL_TRIANGLES);
-		glColor3fv(glm::value_ptr(triangle.material->diffuse));
+		glColor3fv(glm::value_ptr(scene->materials[triangle.material].diffuse));
 
 		auto n = glm::normalize(glm::cross(triangle.u, triangle.v));
 		glNormal3fv(glm::value_ptr(n));
@@ -68,9 +68,9 @@ void traceur::GLUTSceneRenderer::visit(const traceur::Triangle &triangle)
 	glEnd();
 }
 
-void draw_box(const traceur::Box &box, const glm::vec3 &color) {
-	auto min = box.bounding_box().min;
-	auto max = box.bounding_box().max;
+void draw_box(const traceur::AABB &box, const glm::vec3 &color) {
+	auto min = box.min;
+	auto max = box.max;
 
 	glBegin(GL_QUADS);
 		glColor3fv(glm::value_ptr(color));
@@ -110,14 +110,14 @@ void draw_box(const traceur::Box &box, const glm::vec3 &color) {
 
 void traceur::GLUTSceneRenderer::visit(const traceur::Box &box)
 {
-	draw_box(box, box.material->diffuse);
+	draw_box(box, scene->materials[box.material].diffuse);
 
 	if (draw_bounding_box) {
 		visit_bounding_box(box.bounding_box());
 	}
 }
 
-void traceur::GLUTSceneRenderer::visit_bounding_box(const traceur::Box &box)
+void traceur::GLUTSceneRenderer::visit_bounding_box(const traceur::AABB &box)
 {
 	/* Draw wireframe */
 	glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
@@ -25,6 +25,7 @@
 #define TRACEUR_LOADER_WAVEFRONT_H
 
 #include <map>
+#include <vector>
 #include <traceur/loader/loader.hpp>
 
 namespace traceur {
@@ -52,14 +53,18 @@ namespace traceur {
 		virtual std::unique_ptr<traceur::Scene> load(const std::string &) const final;
 
 		/**
-		 * Load the materials of a scene into the given map.
+		 * Load the materials of a scene into the given material table.
 		 *
 		 * @param[in] path The path to the material file.
-		 * @param[in] materials The map to write the materials to.
+		 * @param[in] ids The map from the names of the materials to their
+		 * index in the table.
+		 * @param[in] materials The material table to append the materials to.
 		 * @return <code>true</code> if the loading succeeded, <code>false</code>
 		 * otherwise.
 		 */
-		bool loadMaterials(const std::string &, std::map<std::string, std::shared_ptr<traceur::Material>> &) const;
+		bool loadMaterials(const std::string &,
+						   std::map<std::string, uint32_t> &,
+						   std::vector<traceur::Material> &) const;
 	};
 }
 
@@ -40,7 +40,7 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 	auto builder = factory->create();
 	auto path = filesystem::path(file);
 
-	std::shared_ptr<traceur::Material> defaultMat = std::make_shared<traceur::Material>(
+	traceur::Material defaultMat(
 			glm::vec3(0.f, 0.f, 0.f),   /* Ambient */
 			glm::vec3(0.5f, 0.5f, 0.5f),/* Diffuse */
 			glm::vec3(0.5f, 0.5f, 0.5f),/* Specular */
@@ -51,13 +51,15 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
             1                           /* Illumination model */
 	);
 
-	std::map<std::string, std::shared_ptr<traceur::Material>> materials {
-			{"$default$", defaultMat}
+	std::vector<traceur::Material> materials { defaultMat };
+	std::map<std::string, uint32_t> ids {
+			{"$default$", 0}
 	};
 	float x, y, z;
 
 	std::vector<glm::vec3> vertices;
 	std::string matname;
+	traceur::SceneFeatures features;
 
 	char s[LINE_LEN] = {0};
 	FILE *in = fopen(file.c_str(), "r");
@@ -83,7 +85,7 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 				}
 			}
 			auto matPath = filesystem::path(t.length() == i ? t : t.substr(0, i));
-			loadMaterials((path.parent_path()/matPath).str(), materials);
+			loadMaterials((path.parent_path()/matPath).str(), ids, materials);
 		}
 		// usemtl
 		else if (strncmp(s, "usemtl ", 7) == 0) {
@@ -91,14 +93,14 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 			while( isspace(*++p0) ); p1=p0;
 			while(!isspace(*p1)) ++p1; *p1='\0';
 			matname = p0;
-			if (!materials.count(matname))
+			if (!ids.count(matname))
 			{
 				fprintf(stdout, "warning: material '%s' not defined in material file. Taking default!\n", matname.c_str());
 				matname = "$default$";
 			}
 		}
 		// vertex
-		else if (strncmp(s, "v ", 2) == 0) {
+		else if (s[0] == 'v' && (s[1] == ' ' || s[1] == '\t')) {
 			sscanf(s, "v %f %f %f", &x, &y, &z);
 			vertices.push_back(glm::vec3(x, y, z));
 		}
@@ -156,7 +158,9 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 					switch (component) {
 					// vertex
 					case 0: {
-						int tmp = atoi(p0)-1;
+						// negative indices are relative to the last vertex
+						int tmp = atoi(p0);
+						tmp = tmp < 0 ? static_cast<int>(vertices.size()) + tmp : tmp - 1;
 						vhandles.push_back(tmp);
 						break;
 					}
@@ -194,11 +198,14 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 					const int v1 = (k + i + 1) % vhandles.size();
 					const int v2 = (k + i + 2) % vhandles.size();
 
-					const auto &m = materials[matname];
+					auto m = ids[matname];
 					auto o = vertices[vhandles[v0]];
 					auto u = vertices[vhandles[v1]] - o;
 					auto v = vertices[vhandles[v2]] - o;
-					builder->add(traceur::Triangle(o, u, v, m));
+					auto triangle = traceur::Triangle(o, u, v, m);
+					features.visit(triangle);
+					features.add(materials[m]);
+					builder->add(triangle);
 				}
 			}
 			else if (vhandles.size() == 3) {
@@ -206,8 +213,11 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 				auto u = vertices[vhandles[1]] - o;
 				auto v = vertices[vhandles[2]] - o;
 
-				const auto &m  = materials[matname];
-				builder->add(traceur::Triangle(o, u, v, m));
+				auto m = ids[matname];
+				auto triangle = traceur::Triangle(o, u, v, m);
+				features.visit(triangle);
+				features.add(materials[m]);
+				builder->add(triangle);
 			}
 			else {
 				fprintf(stdout, "warning: unexpected number of face vertices (<3). Ignoring face");
@@ -216,11 +226,15 @@ std::unique_ptr<traceur::Scene> traceur::WavefrontLoader::load(const std::string
 		memset(&s, 0, LINE_LEN);
 	}
 	fclose(in);
-	return std::make_unique<traceur::Scene>(builder->build());
+	auto scene = std::make_unique<traceur::Scene>(builder->build());
+	scene->materials = std::move(materials);
+	scene->features = features;
+	return scene;
 }
 
 bool traceur::WavefrontLoader::loadMaterials(const std::string &path,
-											 std::map<std::string, std::shared_ptr<traceur::Material>> &materials) const
+											 std::map<std::string, uint32_t> &ids,
+											 std::vector<traceur::Material> &materials) const
 {
 	FILE * in = fopen(path.c_str(), "r");
 	if (!in) {
@@ -245,8 +259,9 @@ bool traceur::WavefrontLoader::loadMaterials(const std::string &path,
 		}
 		else if (isspace(line[0]) || line[0] == '\0') {
 			if (indef && !key.empty()) {
-				if (!materials.count(key)) {
-					materials[key] = std::make_shared<traceur::Material>(mat);
+				if (!ids.count(key)) {
+					ids[key] = static_cast<uint32_t>(materials.size());
+					materials.push_back(mat);
 				}
 			}
 			if (line[0] == '\0')
@@ -259,6 +274,8 @@ bool traceur::WavefrontLoader::loadMaterials(const std::string &path,
 			while(!isspace(*p1)) ++p1; *p1='\0';
 			key   = p0;
 			indef = true;
+			// Emission is not carried over from the previous definition
+			mat.emission = glm::vec3(0.f);
 		}
 		// Diffuse factor
 		else if (strncmp(line, "Kd ", 3) == 0) {
@@ -275,6 +292,11 @@ bool traceur::WavefrontLoader::loadMaterials(const std::string &path,
             sscanf(line, "Ks %f %f %f", &f1, &f2, &f3);
             mat.specular = glm::vec3(f1, f2, f3);
         }
+        // Emissive color
+        else if (strncmp(line, "Ke ", 3) == 0) {
+            sscanf(line, "Ke %f %f %f", &f1, &f2, &f3);
+            mat.emission = glm::vec3(f1, f2, f3);
+        }
         // Transmission filter
         else if (strncmp(line, "Tf ", 3) == 0) {
             sscanf(line, "Tf %f %f %f", &f1, &f2, &f3);
@@ -326,8 +348,9 @@ bool traceur::WavefrontLoader::loadMaterials(const std::string &path,
         }
 
 		if (feof(in) && indef && !key.empty()) {
-			if (!materials.count(key)) {
-				materials[key] = std::make_shared<traceur::Material>(mat);
+			if (!ids.count(key)) {
+				ids[key] = static_cast<uint32_t>(materials.size());
+				materials.push_back(mat);
 			}
 		}
 		memset(line, 0, LINE_LEN);